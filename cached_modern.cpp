@@ -0,0 +1,153 @@
+#include <iostream>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+
+#include "perf/cached.hpp"
+#include "perf/bench.hpp"
+#include "perf/parallel.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+// The qualifiers_modern.cpp pattern
+//////////////////////////////////////////////////////////////////////////
+class MutexWidget {
+public:
+    explicit MutexWidget( std::vector<int> data ) : m_data( std::move( data ) ) {}
+
+    int sum() const {
+        std::lock_guard<std::mutex> _{ m_cached_mutex };
+        if ( m_cached == -1 ) {
+            m_cached = std::accumulate( begin( m_data ), end( m_data ), 0 );
+        }
+        return m_cached;
+    }
+
+private:
+    std::vector<int> m_data;
+    mutable std::mutex m_cached_mutex;
+    mutable int m_cached = -1;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Lock-free once filled
+//////////////////////////////////////////////////////////////////////////
+class Widget {
+public:
+    explicit Widget( std::vector<int> data ) : m_data( std::move( data ) ) {}
+
+    // no -1 sentinel either, 0 or -1 are perfectly good sums
+    int sum() const {
+        return m_sum.get( [this] { return std::accumulate( begin( m_data ), end( m_data ), 0 ); } );
+    }
+
+    // non-const access invalidates, like any other mutation it needs exclusive access
+    std::vector<int>& data() & {
+        m_sum.reset();
+        return m_data;
+    }
+
+private:
+    std::vector<int> m_data;
+    perf::cached<int> m_sum;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Bigger than a word and updated while others read
+//////////////////////////////////////////////////////////////////////////
+struct Stats {
+    std::int64_t sum;
+    int min;
+    int max;
+    std::size_t count;
+};
+
+class StatsWidget {
+public:
+    explicit StatsWidget( std::vector<int> data ) : m_data( std::move( data ) ) {}
+
+    Stats stats() const {
+        return m_stats.get( [this] {
+            auto mm = std::minmax_element( m_data.begin(), m_data.end() );
+            return Stats{ std::accumulate( m_data.begin(), m_data.end(), std::int64_t{ 0 } ), *mm.first, *mm.second, m_data.size() };
+        } );
+    }
+
+    // a producer can publish fresh stats while readers keep reading
+    void publish( const Stats& s ) { m_stats.store( s ); }
+
+private:
+    std::vector<int> m_data;
+    perf::seqlock_cached<Stats> m_stats;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Reader scaling
+//////////////////////////////////////////////////////////////////////////
+// ns per call, all readers hammering the same object
+template< typename F >
+double concurrent_reads( unsigned threads, int calls_per_thread, F read ) {
+    std::atomic<bool> go{ false };
+    std::vector<std::thread> readers;
+    for ( unsigned t = 0; t < threads; ++t ) {
+        readers.emplace_back( [&] {
+            while ( !go.load( std::memory_order_acquire ) ) {
+                std::this_thread::yield();
+            }
+            for ( int i = 0; i < calls_per_thread; ++i ) {
+                perf::do_not_optimize( read() );
+            }
+        } );
+    }
+    auto start = std::chrono::steady_clock::now();
+    go.store( true, std::memory_order_release );
+    for ( auto& r : readers ) {
+        r.join();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / ( double( threads ) * calls_per_thread );
+}
+
+int main() {
+    std::vector<int> data( 1000 );
+    std::iota( data.begin(), data.end(), -500 );
+
+    Widget w( data );
+    std::cout << w.sum() << std::endl;
+    w.data().push_back( 1000 );
+    std::cout << w.sum() << std::endl;
+
+    StatsWidget sw( data );
+    Stats s = sw.stats();
+    std::cout << s.sum << " " << s.min << " " << s.max << " " << s.count << std::endl;
+
+    MutexWidget mw( data );
+    const int calls = 1'000'000;
+    std::printf( "%d sum() calls per reader thread, ns per call (%u hardware threads)\n", calls, perf::hardware_threads() );
+    std::printf( "  %7s %12s %12s %15s\n", "readers", "std::mutex", "cached", "seqlock_cached" );
+    for ( unsigned threads = 1; threads <= 64; threads *= 2 ) {
+        double locked = concurrent_reads( threads, calls, [&] { return mw.sum(); } );
+        double cached = concurrent_reads( threads, calls, [&] { return w.sum(); } );
+        double seq = concurrent_reads( threads, calls, [&] { return sw.stats().sum; } );
+        std::printf( "  %7u %12.2f %12.2f %15.2f\n", threads, locked, cached, seq );
+    }
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Summary
+//////////////////////////////////////////////////////////////////////////
+/*
+A mutex taken by readers is a write to shared memory: every reader steals the cache line from the last one.
+Once the value exists, readers should only read.
+
+cached<T> is one acquire load on the hit path, the lock-free equivalent of the mutable mutex recipe.
+seqlock_cached<T> also lets writers replace the value under readers; readers retry instead of block.
+
+The class stays thread-compatible: invalidate from non-const members and synchronize those as usual.
+*/
@@ -0,0 +1,89 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdio>
+
+#include "perf/compact.hpp"
+#include "perf/bench.hpp"
+
+bool is_even( int x ) { return ( x & 1 ) == 0; }
+bool is_odd( int x ) { return !is_even( x ); }
+
+int main() {
+    //////////////////////////////////////////////////////////////////////////
+    // Drop-in for erase-remove
+    //////////////////////////////////////////////////////////////////////////
+    // the same filtering as auto_modern.cpp
+    std::vector<int> values{ 0, 1, 2, 3, 4, 5 };
+    values.erase( std::remove_if( begin( values ), end( values ), is_even ), end( values ) );
+    // values == {1, 3, 5}
+
+    std::vector<int> values2{ 0, 1, 2, 3, 4, 5 };
+    auto new_last = perf::compact_if( values2.data(), values2.data() + values2.size(), is_even );
+    values2.erase( values2.begin() + ( new_last - values2.data() ), values2.end() );
+    std::cout << ( values == values2 ) << std::endl;
+
+    // or the whole idiom in one call
+    perf::erase_if( values2, is_odd );
+    std::cout << values2.size() << std::endl;
+
+    //////////////////////////////////////////////////////////////////////////
+    // Unpredictable data
+    //////////////////////////////////////////////////////////////////////////
+    // random data at 50% selectivity: the branch in remove_if is a coin flip
+    const std::size_t count = 10'000'000;
+    std::mt19937 rng( 1 );
+    std::vector<int> source( count );
+    std::generate( source.begin(), source.end(), [&] { return static_cast<int>( rng() ); } );
+    std::vector<double> source_d( source.begin(), source.end() );
+    auto is_even_d = []( double x ) { return static_cast<long long>( x ) % 2 == 0; };
+
+    std::vector<int> work;
+    std::vector<double> work_d;
+    auto report = [count]( const char* name, double ms ) {
+        std::printf( "  %-28s %8.3f ms %6.2f ns/element\n", name, ms, ms * 1e6 / count );
+    };
+    std::printf( "remove is_even from %zu random ints\n", count );
+    report( "std::remove_if", perf::time_ms( [&] {
+        work = source;
+        perf::do_not_optimize( std::remove_if( work.begin(), work.end(), is_even ) );
+    } ) );
+    work = source;
+    std::vector<int> expected( work.begin(), std::remove_if( work.begin(), work.end(), is_even ) );
+    report( "perf::compact_if", perf::time_ms( [&] {
+        work = source;
+        perf::do_not_optimize( perf::compact_if( work.data(), work.data() + work.size(), is_even ) );
+    } ) );
+    report( "copy only (baseline)", perf::time_ms( [&] { work = source; perf::do_not_optimize( work.data() ); } ) );
+
+    std::printf( "remove even values from %zu random doubles\n", count );
+    report( "std::remove_if", perf::time_ms( [&] {
+        work_d = source_d;
+        perf::do_not_optimize( std::remove_if( work_d.begin(), work_d.end(), is_even_d ) );
+    } ) );
+    report( "perf::compact_if", perf::time_ms( [&] {
+        work_d = source_d;
+        perf::do_not_optimize( perf::compact_if( work_d.data(), work_d.data() + work_d.size(), is_even_d ) );
+    } ) );
+
+    work = source;
+    perf::erase_if( work, is_even );
+    if ( work != expected ) {
+        std::cout << "MISMATCH" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Summary
+//////////////////////////////////////////////////////////////////////////
+/*
+A branch the CPU can't predict costs ~15 cycles every other element.
+
+Turn the decision into data: compute a mask, always write, advance by the mask.
+With SIMD the same idea writes eight elements per step.
+
+Keep the interface identical to the standard algorithm, so switching is a one line change.
+*/
@@ -0,0 +1,105 @@
+#include <iostream>
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdint>
+#include <cstdio>
+
+#include "perf/compare.hpp"
+#include "perf/bench.hpp"
+
+// compares count pairs of equal arrays, the worst case: every element has to be looked at
+template< typename T, std::size_t N >
+void benchmark_equal_pairs( const char* type ) {
+    constexpr std::size_t count = 1'000'000 / N + 1000;
+    std::vector<std::array<T, N>> lhs( count ), rhs( count );
+    std::mt19937 rng( 42 );
+    for ( std::size_t i = 0; i < count; ++i ) {
+        for ( auto& x : lhs[i] ) {
+            x = static_cast<T>( rng() );
+        }
+        rhs[i] = lhs[i];
+    }
+
+    auto measure = [&]( auto compare ) {
+        return perf::time_ms( [&] {
+            std::size_t hits = 0;
+            for ( std::size_t i = 0; i < count; ++i ) {
+                hits += compare( lhs[i], rhs[i] );
+            }
+            perf::do_not_optimize( hits );
+        } ) * 1e6 / count;
+    };
+    double std_eq = measure( []( const auto& a, const auto& b ) { return a == b; } );
+    double perf_eq = measure( []( const auto& a, const auto& b ) { return perf::equal( a, b ); } );
+    double std_lt = measure( []( const auto& a, const auto& b ) { return a < b; } );
+    double perf_lt = measure( []( const auto& a, const auto& b ) { return perf::compare_three_way( a, b ) < 0; } );
+    char name[64];
+    std::snprintf( name, sizeof( name ), "std::array<%s, %zu>", type, N );
+    std::printf( "  %-26s == %8.1f ns  perf::equal %8.1f ns %6.2fx   < %8.1f ns  perf::compare_three_way %8.1f ns %6.2fx\n",
+                 name, std_eq, perf_eq, std_eq / perf_eq, std_lt, perf_lt, std_lt / perf_lt );
+}
+
+// sorts and deduplicates records that share long prefixes, so every comparison goes deep
+void benchmark_dedup() {
+    using Record = std::array<std::int32_t, 64>;
+    constexpr std::size_t count = 200'000;
+    std::mt19937 rng( 42 );
+    std::vector<Record> prefixes( 16 );
+    for ( auto& p : prefixes ) {
+        for ( auto& x : p ) {
+            x = static_cast<std::int32_t>( rng() );
+        }
+    }
+    std::vector<Record> records( count );
+    for ( auto& r : records ) {
+        r = prefixes[rng() % prefixes.size()];
+        r[60 + rng() % 4] = static_cast<std::int32_t>( rng() % 1000 );
+    }
+
+    // one run each, a second run would sort sorted data
+    std::vector<Record> expected = records;
+    double std_ms = perf::time_ms( [&] {
+        std::sort( expected.begin(), expected.end() );
+        expected.erase( std::unique( expected.begin(), expected.end() ), expected.end() );
+    }, 1 );
+    std::vector<Record> unique = records;
+    double perf_ms = perf::time_ms( [&] {
+        std::sort( unique.begin(), unique.end(), perf::lexicographic_less{} );
+        unique.erase( std::unique( unique.begin(), unique.end(), perf::lexicographic_equal{} ), unique.end() );
+    }, 1 );
+    std::printf( "  sort + unique %zu records of 64 ints -> %zu   std %8.1f ms  perf %8.1f ms %6.2fx %s\n", count,
+                 unique.size(), std_ms, perf_ms, std_ms / perf_ms, unique == expected ? "" : "WRONG" );
+}
+
+int main() {
+    // the arrays of arrays_modern.cpp
+    std::array<int, 6> values = { 0, 1, 2, 3, 4, 5 };
+    std::array<int, 6> values2 = { 0, 1, 2, 3, 4, 6 };
+    std::cout << perf::equal( values, values2 ) << " " << perf::compare_three_way( values, values2 ) << std::endl;
+
+    std::printf( "equal arrays, per comparison\n" );
+    benchmark_equal_pairs<std::int32_t, 6>( "int" );
+    benchmark_equal_pairs<std::int32_t, 64>( "int" );
+    benchmark_equal_pairs<std::int32_t, 1024>( "int" );
+    benchmark_equal_pairs<std::uint8_t, 256>( "uint8_t" );
+    benchmark_equal_pairs<double, 256>( "double" );
+    std::printf( "deduplicating\n" );
+    benchmark_dedup();
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Summary
+//////////////////////////////////////////////////////////////////////////
+/*
+std::array compares element by element, in order. == and < on large arrays are loops that load, compare and branch once per element.
+Both questions come down to finding the first element that differs.
+With wide loads you compare 32 bytes per instruction and only branch when a whole block has a difference.
+Then compare the one mismatching pair to decide the order.
+Standard libraries already turn == on integer arrays, and < on unsigned bytes, into memcmp.
+What is left to gain is < on wider integers and both operators on floating point, which is where sorting and deduplicating records spend their time.
+Element types whose == is a plain value compare, integers, enums and floating point, can use the fast path.
+For everything else, keep using the standard algorithms.
+*/
@@ -0,0 +1,126 @@
+#include <iostream>
+#include <vector>
+#include <numeric>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <cstdio>
+#include <cstdint>
+
+#include "perf/cow_vector.hpp"
+#include "perf/bench.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+// Widget with cheap snapshots
+//////////////////////////////////////////////////////////////////////////
+class Widget {
+public:
+    explicit Widget( const std::vector<int>& data ) : m_data( data ) {}
+
+    // qualifiers_modern.cpp offers a const& (tied to the widget's lifetime and changes)
+    // or a move out (the widget loses its data); a snapshot is neither and costs O(1)
+    perf::cow_vector<int> snapshot() const { return m_data; }
+
+    void set( std::size_t i, int v ) { m_data.set( i, v ); }
+    int get( std::size_t i ) const { return m_data[i]; }
+
+private:
+    perf::cow_vector<int> m_data;
+};
+
+std::int64_t sum( const perf::cow_vector<int>& v ) {
+    std::int64_t total = 0;
+    v.for_each_chunk( [&total]( const int* p, std::size_t n ) { total = std::accumulate( p, p + n, total ); } );
+    return total;
+}
+
+int main() {
+    Widget w( std::vector<int>( 10, 1 ) );
+    auto before = w.snapshot();
+    w.set( 0, 100 );
+    std::cout << sum( before ) << " " << sum( w.snapshot() ) << std::endl;
+
+    //////////////////////////////////////////////////////////////////////////
+    // Snapshot cost
+    //////////////////////////////////////////////////////////////////////////
+    const std::size_t count = 10'000'000;
+    std::vector<int> plain( count );
+    std::iota( plain.begin(), plain.end(), 0 );
+    perf::cow_vector<int> cow( plain );
+    std::mt19937 rng( 9 );
+    std::vector<std::size_t> writes( 100 );
+    for ( auto& i : writes ) {
+        i = rng() % count;
+    }
+
+    auto report = []( const char* name, double ms ) { std::printf( "  %-36s %10.4f ms\n", name, ms ); };
+    std::printf( "%zu ints\n", count );
+    report( "std::vector copy", perf::time_ms( [&] { std::vector<int> copy = plain; perf::do_not_optimize( copy.data() ); } ) );
+    report( "cow_vector snapshot", perf::time_ms( [&] { perf::cow_vector<int> copy = cow; perf::do_not_optimize( copy ); } ) );
+    report( "std::vector copy + 100 writes", perf::time_ms( [&] {
+        std::vector<int> copy = plain;
+        for ( auto i : writes ) plain[i] += 1;
+        perf::do_not_optimize( copy.data() );
+    } ) );
+    report( "cow_vector snapshot + 100 writes", perf::time_ms( [&] {
+        perf::cow_vector<int> copy = cow;
+        for ( auto i : writes ) cow.mutable_ref( i ) += 1;
+        perf::do_not_optimize( copy );
+    } ) );
+    report( "std::vector full scan", perf::time_ms( [&] {
+        perf::do_not_optimize( std::accumulate( plain.begin(), plain.end(), std::int64_t{ 0 } ) );
+    } ) );
+    report( "cow_vector full scan", perf::time_ms( [&] { perf::do_not_optimize( sum( cow ) ); } ) );
+
+    //////////////////////////////////////////////////////////////////////////
+    // Point-in-time views for concurrent readers
+    //////////////////////////////////////////////////////////////////////////
+    // the writer moves one unit between two elements at a time, so every consistent view has the same sum
+    std::mutex published_mutex;
+    perf::cow_vector<int> published = cow;
+    const std::int64_t expected = sum( published );
+    std::atomic<bool> done{ false };
+    std::atomic<int> views{ 0 }, torn{ 0 };
+
+    std::vector<std::thread> readers;
+    for ( int r = 0; r < 2; ++r ) {
+        readers.emplace_back( [&] {
+            while ( !done.load() ) {
+                perf::cow_vector<int> view;
+                {
+                    // held for a pointer copy, not for the scan
+                    std::lock_guard<std::mutex> _{ published_mutex };
+                    view = published;
+                }
+                torn += sum( view ) != expected;
+                ++views;
+            }
+        } );
+    }
+    perf::cow_vector<int> working = published;
+    for ( int i = 0; i < 200'000; ++i ) {
+        working.mutable_ref( rng() % count ) += 1;
+        working.mutable_ref( rng() % count ) -= 1;
+        if ( i % 64 == 0 ) {
+            std::lock_guard<std::mutex> _{ published_mutex };
+            published = working;
+        }
+    }
+    done = true;
+    for ( auto& r : readers ) {
+        r.join();
+    }
+    std::printf( "%d full scans of published snapshots while writing, %d inconsistent\n", views.load(), torn.load() );
+    return torn.load() == 0 ? 0 : 1;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Summary
+//////////////////////////////////////////////////////////////////////////
+/*
+A snapshot shouldn't cost a deep copy. Share the data and copy lazily, and only the part that changes.
+
+Chunking bounds what a write copies; refcounts tell you when nobody else can see the chunk and you may write in place.
+Readers never lock for the scan, only to grab the current root.
+*/
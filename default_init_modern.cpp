@@ -0,0 +1,101 @@
+#include <iostream>
+#include <vector>
+#include <numeric>
+#include <cstdio>
+
+#include "perf/default_init_allocator.hpp"
+#include "perf/vector.hpp"
+#include "perf/bench.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+// heavy_result_type from parameter_modern.cpp, filled for real
+//////////////////////////////////////////////////////////////////////////
+// resize zeroes 100'000 ints, iota immediately overwrites them
+std::vector<int> heavy_result_type() {
+    std::vector<int> results;
+    results.resize( 100'000 );
+    std::iota( results.begin(), results.end(), 0 );
+    return results;
+}
+
+// same code, the allocator turns the zeroing into nothing
+perf::default_init_vector<int> heavy_result_type_default_init() {
+    perf::default_init_vector<int> results;
+    results.resize( 100'000 );
+    std::iota( results.begin(), results.end(), 0 );
+    return results;
+}
+
+// or say it explicitly
+perf::vector<int> heavy_result_type_uninitialized() {
+    perf::vector<int> results;
+    results.resize_uninitialized( 100'000 );
+    std::iota( results.begin(), results.end(), 0 );
+    return results;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Fill after resize
+//////////////////////////////////////////////////////////////////////////
+// the buffer is reused, so this is memory bandwidth only: no malloc, no page faults
+template< typename Vector >
+double fill_after_resize( Vector& v, std::size_t n ) {
+    return perf::time_ms( [&] {
+        v.clear();
+        v.resize( n );
+        std::iota( v.begin(), v.end(), 0 );
+        perf::do_not_optimize( v.data() );
+    } );
+}
+
+double fill_after_push_back( std::vector<int>& v, std::size_t n ) {
+    return perf::time_ms( [&] {
+        v.clear();
+        for ( std::size_t i = 0; i < n; ++i ) {
+            v.push_back( static_cast<int>( i ) );
+        }
+        perf::do_not_optimize( v.data() );
+    } );
+}
+
+double fill_after_resize_uninitialized( perf::vector<int>& v, std::size_t n ) {
+    return perf::time_ms( [&] {
+        v.clear();
+        v.resize_uninitialized( n );
+        std::iota( v.begin(), v.end(), 0 );
+        perf::do_not_optimize( v.data() );
+    } );
+}
+
+int main() {
+    std::cout << heavy_result_type()[99'999] << " " << heavy_result_type_default_init()[99'999] << " "
+              << heavy_result_type_uninitialized()[99'999] << std::endl;
+
+    std::printf( "resize + iota into a reused buffer, GB/s of useful output\n" );
+    std::printf( "  %10s %12s %12s %14s %22s\n", "ints", "resize", "push_back", "default_init", "resize_uninitialized" );
+    for ( std::size_t n = 100'000; n <= 100'000'000; n *= 10 ) {
+        auto gbs = [n]( double ms ) { return double( n * sizeof( int ) ) / ( ms * 1e6 ); };
+        // one buffer alive at a time, 10^8 ints is 400MB
+        auto with_capacity = [n]( auto v ) {
+            v.reserve( n );
+            return v;
+        };
+        double resize = gbs( [&] { auto v = with_capacity( std::vector<int>{} ); return fill_after_resize( v, n ); }() );
+        double push_back = gbs( [&] { auto v = with_capacity( std::vector<int>{} ); return fill_after_push_back( v, n ); }() );
+        double default_init = gbs( [&] { auto v = with_capacity( perf::default_init_vector<int>{} ); return fill_after_resize( v, n ); }() );
+        double uninitialized = gbs( [&] { auto v = with_capacity( perf::vector<int>{} ); return fill_after_resize_uninitialized( v, n ); }() );
+        std::printf( "  %10zu %12.2f %12.2f %14.2f %22.2f\n", n, resize, push_back, default_init, uninitialized );
+    }
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Summary
+//////////////////////////////////////////////////////////////////////////
+/*
+resize(n) value-initializes: for ints that is a memset you pay for and then overwrite.
+Once the data no longer fits in cache, that is a full extra pass over memory.
+
+push_back avoids it but pays a capacity check per element.
+Default-initialization writes nothing; just never read an element before you've written it.
+*/
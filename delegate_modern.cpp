@@ -0,0 +1,98 @@
+#include <iostream>
+#include <functional>
+#include <vector>
+#include <cstdio>
+#include <type_traits>
+
+#include "perf/delegate.hpp"
+#include "perf/bench.hpp"
+
+using PlayerId = int;
+
+//////////////////////////////////////////////////////////////////////////
+// Function pointer typedefs can't carry state
+//////////////////////////////////////////////////////////////////////////
+// the Callback from typedef_modern.cpp, only stateless lambdas convert to it
+using Callback = void ( * )( PlayerId );
+
+// same call signature, but room for 16 bytes of captured state
+using PlayerCallback = perf::delegate<void( PlayerId ), 16>;
+
+static_assert( sizeof( PlayerCallback ) == 16 + sizeof( void* ), "storage plus one pointer" );
+static_assert( std::is_trivially_copyable<PlayerCallback>::value, "copies are memcpy, tables can be memcpy'd" );
+
+struct Scoreboard {
+    void on_spawn( PlayerId pid ) { total += pid; }
+    long long total = 0;
+};
+
+long long g_total = 0;
+void add_to_total( PlayerId pid ) { g_total += pid; }
+
+int main() {
+    //////////////////////////////////////////////////////////////////////////
+    // Stateful callbacks
+    //////////////////////////////////////////////////////////////////////////
+    PlayerId pid = 76;
+    Callback callback = []( PlayerId pid ) { std::cout << pid << std::endl; };
+    callback( pid );
+
+    int calls = 0;
+    PlayerCallback counted = [&calls]( PlayerId pid ) { ++calls; std::cout << pid << std::endl; };
+    counted( pid );
+
+    Scoreboard board;
+    auto spawn = PlayerCallback::bind<&Scoreboard::on_spawn>( &board );
+    spawn( pid );
+    std::cout << calls << " " << board.total << std::endl;
+
+#ifdef BAD
+    // too much state is a compile error, not a hidden heap allocation
+    char big[64] = {};
+    PlayerCallback too_big = [big]( PlayerId ) {};
+    // owning captures would make the delegate non-trivially copyable
+    PlayerCallback owner = [v = std::vector<int>{}]( PlayerId ) {};
+#endif
+
+    //////////////////////////////////////////////////////////////////////////
+    // Event tables
+    //////////////////////////////////////////////////////////////////////////
+    const int count = 1'000'000;
+    std::vector<Callback> raw( count, &add_to_total );
+    std::vector<PlayerCallback> delegates;
+    std::vector<std::function<void( PlayerId )>> functions;
+    std::vector<Scoreboard> boards( 16 );
+    for ( int i = 0; i < count; ++i ) {
+        auto* b = &boards[i % boards.size()];
+        delegates.push_back( PlayerCallback::bind<&Scoreboard::on_spawn>( b ) );
+        functions.push_back( [b]( PlayerId pid ) { b->on_spawn( pid ); } );
+    }
+
+    std::printf( "sizeof Callback %zu, PlayerCallback %zu, std::function %zu\n",
+                 sizeof( Callback ), sizeof( PlayerCallback ), sizeof( std::function<void( PlayerId )> ) );
+    auto report = [count]( const char* name, double ms ) {
+        std::printf( "  %-28s %7.2f ns/call\n", name, ms * 1e6 / count );
+    };
+    std::printf( "invoke %d callbacks\n", count );
+    report( "function pointer", perf::time_ms( [&] { for ( auto& c : raw ) c( 1 ); } ) );
+    report( "perf::delegate", perf::time_ms( [&] { for ( auto& d : delegates ) d( 1 ); } ) );
+    report( "std::function", perf::time_ms( [&] { for ( auto& f : functions ) f( 1 ); } ) );
+
+    std::printf( "copy the table\n" );
+    report( "perf::delegate", perf::time_ms( [&] { auto copy = delegates; perf::do_not_optimize( copy.data() ); } ) );
+    report( "std::function", perf::time_ms( [&] { auto copy = functions; perf::do_not_optimize( copy.data() ); } ) );
+    perf::do_not_optimize( g_total );
+    perf::do_not_optimize( boards[0].total );
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Summary
+//////////////////////////////////////////////////////////////////////////
+/*
+Function pointers are small and fast but can't carry state.
+std::function carries any state but may allocate, is large and copies are not memcpy.
+
+A fixed-size delegate sits in between: bounded state, no allocation, one indirect call,
+and a compile error instead of a surprise when the state doesn't fit.
+*/
@@ -0,0 +1,74 @@
+#include <iostream>
+#include <vector>
+#include <list>
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+
+#include "perf/find.hpp"
+#include "perf/bench.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+// The overload set from parameter_modern.cpp
+//////////////////////////////////////////////////////////////////////////
+template< class InputIt, class Value >
+bool std_all_equal( InputIt f, InputIt l, const Value& v ) {
+    return std::all_of( f, l, [&v]( auto&& x ) { return x == v; } );
+}
+
+template< class InputIt, class Value >
+bool std_any_equal( InputIt f, InputIt l, const Value& v ) {
+    return std::find( f, l, v ) != l;
+}
+
+template< typename T >
+void benchmark( const char* type, std::size_t n ) {
+    // worst case for both: all_equal has to look at every element, any_equal finds nothing
+    std::vector<T> results( n );
+    const int repeats = static_cast<int>( 100'000'000 / n );
+    auto gbs = [&]( double ms ) { return double( n * sizeof( T ) ) * repeats / ( ms * 1e6 ); };
+    double std_all = perf::time_ms( [&] {
+        for ( int i = 0; i < repeats; ++i ) perf::do_not_optimize( std_all_equal( results.begin(), results.end(), T( 0 ) ) );
+    } );
+    double perf_all = perf::time_ms( [&] {
+        for ( int i = 0; i < repeats; ++i ) perf::do_not_optimize( perf::all_equal( results, T( 0 ) ) );
+    } );
+    double std_any = perf::time_ms( [&] {
+        for ( int i = 0; i < repeats; ++i ) perf::do_not_optimize( std_any_equal( results.begin(), results.end(), T( 1 ) ) );
+    } );
+    double perf_any = perf::time_ms( [&] {
+        for ( int i = 0; i < repeats; ++i ) perf::do_not_optimize( perf::any_equal( results, T( 1 ) ) );
+    } );
+    std::printf( "  %-8s %10zu %10.2f %10.2f %10.2f %10.2f\n", type, n, gbs( std_all ), gbs( perf_all ), gbs( std_any ),
+                 gbs( perf_any ) );
+}
+
+int main() {
+    std::vector<int> results( 100'000 );
+    bool allZero = perf::all_equal( results, 0 );
+    std::cout << allZero << std::endl;
+
+    // not contiguous, same call, std::find underneath
+    std::list<int> values{ 1, 2, 3 };
+    std::cout << perf::any_equal( values, 2 ) << perf::none_equal( values, 4 ) << std::endl;
+
+    std::printf( "GB/s scanned, no early exit\n" );
+    std::printf( "  %-8s %10s %10s %10s %10s %10s\n", "type", "elements", "std all", "perf all", "std any", "perf any" );
+    for ( std::size_t n : { std::size_t{ 1'000 }, std::size_t{ 100'000 }, std::size_t{ 10'000'000 } } ) {
+        benchmark<std::uint8_t>( "uint8", n );
+        benchmark<int>( "int", n );
+        benchmark<double>( "double", n );
+    }
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Summary
+//////////////////////////////////////////////////////////////////////////
+/*
+std::find compares one element and branches once per element.
+A vector compare checks 32 bytes at once; OR four of them together and branch once per 128 bytes.
+
+Keep the overload set, specialize underneath: callers write all_equal(results, 0) either way.
+Only take the fast path when it gives the same answer as ==.
+*/
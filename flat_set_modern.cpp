@@ -0,0 +1,102 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <unordered_set>
+#include <random>
+#include <cstdio>
+
+#include "perf/flat_set.hpp"
+#include "perf/bench.hpp"
+
+using PlayerId = int;
+// the container from typedef_modern.cpp, membership is a linear scan
+using PlayerIdContainer = std::vector<PlayerId>;
+// sorted, membership is a binary search
+using PlayerIdSet = perf::flat_set<PlayerId>;
+
+template< typename Contains >
+double ns_per_lookup( const std::vector<PlayerId>& queries, Contains&& contains ) {
+    double ms = perf::time_ms( [&] {
+        int hits = 0;
+        for ( auto q : queries ) {
+            hits += contains( q );
+        }
+        perf::do_not_optimize( hits );
+    }, 3 );
+    return ms * 1e6 / static_cast<double>( queries.size() );
+}
+
+int main() {
+    //////////////////////////////////////////////////////////////////////////
+    // Usage
+    //////////////////////////////////////////////////////////////////////////
+    PlayerIdSet players{ 76, 12, 99 };
+    // bulk insert sorts the new ids and merges them in, duplicates are dropped
+    std::vector<PlayerId> joined = { 5, 76, 40 };
+    players.insert( joined.begin(), joined.end() );
+    std::cout << players.size() << " players, contains 40: " << players.contains( 40 ) << std::endl;
+
+    perf::flat_map<PlayerId, int> scores;
+    scores[76] = 10;
+    scores.insert_or_assign( 12, 3 );
+    std::cout << "score of 76: " << *scores.find( 76 ) << std::endl;
+
+    //////////////////////////////////////////////////////////////////////////
+    // Membership checks
+    //////////////////////////////////////////////////////////////////////////
+    std::mt19937 rng( 7 );
+    for ( std::size_t size : { std::size_t{ 10'000 }, std::size_t{ 100'000 }, std::size_t{ 1'000'000 } } ) {
+        std::uniform_int_distribution<PlayerId> ids( 0, static_cast<PlayerId>( size * 4 ) );
+        PlayerIdContainer unsorted( size );
+        std::generate( unsorted.begin(), unsorted.end(), [&] { return ids( rng ); } );
+        std::vector<PlayerId> queries( 1'000'000 );
+        std::generate( queries.begin(), queries.end(), [&] { return ids( rng ); } );
+
+        PlayerIdSet set( unsorted.begin(), unsorted.end() );
+        perf::eytzinger_set<PlayerId> eytzinger( set );
+        std::vector<PlayerId> sorted( set.begin(), set.end() );
+        std::unordered_set<PlayerId> hashed( unsorted.begin(), unsorted.end() );
+
+        for ( auto q : queries ) {
+            bool expected = std::binary_search( sorted.begin(), sorted.end(), q );
+            if ( set.contains( q ) != expected || eytzinger.contains( q ) != expected ) {
+                std::cout << "MISMATCH" << std::endl;
+                return 1;
+            }
+        }
+
+        std::printf( "%zu players\n", size );
+        if ( size <= 10'000 ) {
+            std::vector<PlayerId> few( queries.begin(), queries.begin() + 10'000 );
+            std::printf( "  %-28s %8.1f ns\n", "linear scan", ns_per_lookup( few, [&]( PlayerId q ) {
+                return std::find( unsorted.begin(), unsorted.end(), q ) != unsorted.end();
+            } ) );
+        }
+        std::printf( "  %-28s %8.1f ns\n", "std::binary_search", ns_per_lookup( queries, [&]( PlayerId q ) {
+            return std::binary_search( sorted.begin(), sorted.end(), q );
+        } ) );
+        std::printf( "  %-28s %8.1f ns\n", "std::unordered_set", ns_per_lookup( queries, [&]( PlayerId q ) {
+            return hashed.count( q ) != 0;
+        } ) );
+        std::printf( "  %-28s %8.1f ns\n", "perf::flat_set", ns_per_lookup( queries, [&]( PlayerId q ) {
+            return set.contains( q );
+        } ) );
+        std::printf( "  %-28s %8.1f ns\n", "perf::eytzinger_set", ns_per_lookup( queries, [&]( PlayerId q ) {
+            return eytzinger.contains( q );
+        } ) );
+    }
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Summary
+//////////////////////////////////////////////////////////////////////////
+/*
+If you look things up more often than you insert, keep the vector sorted.
+
+A binary search over random keys mispredicts half its branches, write it so the compiler
+emits conditional moves instead.
+
+Once the set outgrows the cache, the layout matters more than the comparisons.
+Eytzinger order keeps the top of every search in the same few cache lines.
+*/
@@ -0,0 +1,112 @@
+#include <iostream>
+#include <vector>
+#include <unordered_set>
+#include <random>
+#include <functional>
+#include <cstdio>
+
+#include "perf/hash_set.hpp"
+#include "perf/bench.hpp"
+
+using PlayerId = int;
+
+//////////////////////////////////////////////////////////////////////////
+// RegularWidget from class_modern.cpp
+//////////////////////////////////////////////////////////////////////////
+class RegularWidget {
+public:
+    RegularWidget() = default;
+    explicit RegularWidget( int ordinal ) : m_ordinal( ordinal ) {}
+
+    int ordinal() const { return m_ordinal; }
+
+    friend bool operator==( const RegularWidget& lhs, const RegularWidget& rhs ) { return lhs.m_ordinal == rhs.m_ordinal; }
+    friend bool operator!=( const RegularWidget& lhs, const RegularWidget& rhs ) { return !( lhs == rhs ); }
+
+private:
+    int m_ordinal = 0;
+};
+
+// hashes a widget and its ordinal alike, so a set of widgets can be searched by ordinal
+struct widget_hash {
+    using is_transparent = void;
+    std::size_t operator()( const RegularWidget& w ) const noexcept { return std::hash<int>()( w.ordinal() ); }
+    std::size_t operator()( int ordinal ) const noexcept { return std::hash<int>()( ordinal ); }
+};
+
+struct widget_equal {
+    using is_transparent = void;
+    bool operator()( const RegularWidget& a, const RegularWidget& b ) const noexcept { return a == b; }
+    bool operator()( int ordinal, const RegularWidget& w ) const noexcept { return ordinal == w.ordinal(); }
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Benchmark
+//////////////////////////////////////////////////////////////////////////
+template< typename Set >
+void benchmark( const char* name, const std::vector<PlayerId>& keys, const std::vector<PlayerId>& misses ) {
+    const double n = static_cast<double>( keys.size() );
+    Set set;
+    // one run, a second would find everything already there
+    double insert = perf::time_ms( [&] {
+        for ( PlayerId k : keys ) {
+            set.insert( k );
+        }
+    }, 1 );
+    auto lookups = [&]( const std::vector<PlayerId>& queries ) {
+        return perf::time_ms( [&] {
+            std::size_t found = 0;
+            for ( PlayerId q : queries ) {
+                found += set.count( q );
+            }
+            perf::do_not_optimize( found );
+        }, 3 );
+    };
+    double hit = lookups( keys );
+    double miss = lookups( misses );
+    std::printf( "  %-26s %10.1f %10.1f %10.1f\n", name, insert * 1e6 / n, hit * 1e6 / n, miss * 1e6 / n );
+}
+
+int main() {
+    perf::hash_set<PlayerId> players{ 76, 12, 99 };
+    players.insert( 40 );
+    players.erase( 12 );
+    std::cout << players.size() << " players, contains 40: " << players.contains( 40 ) << std::endl;
+
+    // heterogeneous lookup: no RegularWidget is built to ask about ordinal 7
+    perf::hash_set<RegularWidget, widget_hash, widget_equal> widgets{ RegularWidget( 7 ), RegularWidget( 3 ) };
+    std::cout << "widget 7: " << widgets.contains( 7 ) << ", widget 8: " << widgets.contains( 8 ) << std::endl;
+
+    perf::hash_map<PlayerId, int> scores;
+    scores[76] += 10;
+    scores.try_emplace( 12, 3 );
+    std::cout << "score of 76: " << scores.at( 76 ) << std::endl;
+
+    std::mt19937 rng( 11 );
+    std::printf( "ns per operation, random ids, lookups of every inserted id and of as many missing ones\n" );
+    for ( std::size_t size : { std::size_t{ 10'000 }, std::size_t{ 1'000'000 }, std::size_t{ 10'000'000 } } ) {
+        // even ids are in the set, odd ids are misses
+        std::uniform_int_distribution<PlayerId> ids( 0, 1 << 30 );
+        std::vector<PlayerId> keys( size ), misses( size );
+        for ( std::size_t i = 0; i < size; ++i ) {
+            keys[i] = ids( rng ) * 2;
+            misses[i] = ids( rng ) * 2 + 1;
+        }
+        std::printf( "%zu ids\n  %-26s %10s %10s %10s\n", size, "", "insert", "hit", "miss" );
+        benchmark<std::unordered_set<PlayerId>>( "std::unordered_set", keys, misses );
+        benchmark<perf::hash_set<PlayerId>>( "perf::hash_set", keys, misses );
+    }
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Summary
+//////////////////////////////////////////////////////////////////////////
+/*
+std::unordered_set makes an allocation per element, and every lookup chases a pointer to a node somewhere on the heap.
+Open addressing keeps the elements in one array. A byte of hash per slot filters the candidates 16 at a time,
+so most lookups compare one key and most misses compare none.
+
+Regular types make this easy: operator== and a hash are all the table needs.
+Make both transparent and you can look up by a cheaper key without building a temporary.
+*/
@@ -0,0 +1,102 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <numeric>
+#include <cstdio>
+#include <cstdint>
+
+#include "perf/huge_page_allocator.hpp"
+#include "perf/bench.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+// heavy_result_type from parameter_modern.cpp, at deployment size
+//////////////////////////////////////////////////////////////////////////
+perf::huge_page_vector<int> heavy_result_type( std::size_t n ) {
+    perf::huge_page_vector<int> results;
+    results.resize( n );
+    std::iota( results.begin(), results.end(), 0 );
+    return results;
+}
+
+// how much of this process is backed by transparent huge pages right now
+long anon_huge_pages_kb() {
+    std::ifstream smaps( "/proc/self/smaps_rollup" );
+    std::string key;
+    long kb = 0;
+    while ( smaps >> key ) {
+        if ( key == "AnonHugePages:" && smaps >> kb ) {
+            return kb;
+        }
+        smaps.ignore( 256, '\n' );
+    }
+    return -1;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Access patterns
+//////////////////////////////////////////////////////////////////////////
+template< typename Vector >
+double sequential_ms( const Vector& v ) {
+    return perf::time_ms( [&] {
+        std::int64_t sum = 0;
+        for ( int x : v ) {
+            sum += x;
+        }
+        perf::do_not_optimize( sum );
+    } );
+}
+
+// independent reads at pseudo random positions, n must be a power of two
+template< typename Vector >
+double random_ms( const Vector& v, std::size_t reads ) {
+    const std::size_t mask = v.size() - 1;
+    return perf::time_ms( [&] {
+        std::int64_t sum = 0;
+        std::uint64_t x = 88172645463325252ull;
+        for ( std::size_t i = 0; i < reads; ++i ) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            sum += v[x & mask];
+        }
+        perf::do_not_optimize( sum );
+    } );
+}
+
+template< typename Vector >
+void benchmark( const char* name, std::size_t n ) {
+    const std::size_t reads = 20'000'000;
+    Vector v( n );
+    std::iota( v.begin(), v.end(), 0 );
+    double seq = sequential_ms( v );
+    double rnd = random_ms( v, reads );
+    std::printf( "  %-24s %10.2f %14.2f %14ld\n", name, double( n * sizeof( int ) ) / ( seq * 1e6 ), rnd * 1e6 / reads,
+                 anon_huge_pages_kb() / 1024 );
+}
+
+int main() {
+    std::cout << heavy_result_type( 1'000'000 )[999'999] << std::endl;
+
+    for ( std::size_t n : { std::size_t{ 1 } << 24, std::size_t{ 1 } << 28 } ) {
+        std::printf( "%zu MB of ints\n", n * sizeof( int ) >> 20 );
+        std::printf( "  %-24s %10s %14s %14s\n", "", "seq GB/s", "random ns/read", "THP MB" );
+        benchmark<std::vector<int>>( "std::vector", n );
+        benchmark<perf::huge_page_vector<int>>( "perf::huge_page_vector", n );
+    }
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Summary
+//////////////////////////////////////////////////////////////////////////
+/*
+A 4KB page TLB covers a few megabytes; past that every random read also walks the page table.
+2MB pages make the same TLB cover gigabytes.
+
+Sequential scans barely notice: the prefetcher hides the walks.
+Random access into a big buffer is where it pays.
+
+Transparent huge pages need 2MB-aligned ranges and, in "madvise" mode, the madvise.
+Check AnonHugePages in /proc/self/smaps to see whether you actually got them.
+*/
@@ -0,0 +1,110 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include "perf/inline_vector.hpp"
+#include "perf/bench.hpp"
+
+using PlayerId = int;
+
+//////////////////////////////////////////////////////////////////////////
+// Counting allocations
+//////////////////////////////////////////////////////////////////////////
+// every operator new in the program goes through here
+static std::size_t g_allocations = 0;
+
+void* operator new( std::size_t bytes ) {
+    ++g_allocations;
+    if ( void* p = std::malloc( bytes != 0 ? bytes : 1 ) ) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void operator delete( void* p ) noexcept { std::free( p ); }
+void operator delete( void* p, std::size_t ) noexcept { std::free( p ); }
+
+// a team roster per match: a handful of players, never more than 16
+template< typename Roster >
+void benchmark( const char* name, const std::vector<int>& sizes ) {
+    std::size_t allocations = g_allocations;
+    long long total = 0;
+    double ms = perf::time_ms( [&] {
+        total = 0;
+        std::vector<Roster> rosters( sizes.size() );
+        for ( std::size_t m = 0; m < sizes.size(); ++m ) {
+            for ( int p = 0; p < sizes[m]; ++p ) {
+                rosters[m].push_back( static_cast<PlayerId>( m + p ) );
+            }
+        }
+        for ( const auto& roster : rosters ) {
+            for ( PlayerId id : roster ) {
+                total += id;
+            }
+        }
+    }, 1 );
+    // less the one for the vector of rosters
+    double per_roster = static_cast<double>( g_allocations - allocations - 1 ) / sizes.size();
+    std::printf( "    %-34s %8.1f ns/roster %6.2f allocations/roster %4zu bytes/roster %lld\n", name,
+                 ms * 1e6 / sizes.size(), per_roster, sizeof( Roster ), total );
+}
+
+void benchmark_sizes( int min_size, int max_size ) {
+    constexpr std::size_t count = 1'000'000;
+    std::mt19937 rng( 42 );
+    std::vector<int> sizes( count );
+    for ( auto& s : sizes ) {
+        s = min_size + static_cast<int>( rng() % static_cast<unsigned>( max_size - min_size + 1 ) );
+    }
+    std::printf( "  %zu rosters of %d to %d players\n", count, min_size, max_size );
+    benchmark<std::vector<PlayerId>>( "std::vector<PlayerId>", sizes );
+    benchmark<perf::static_vector<PlayerId, 16>>( "perf::static_vector<PlayerId, 16>", sizes );
+    benchmark<perf::small_vector<PlayerId, 4>>( "perf::small_vector<PlayerId, 4>", sizes );
+    benchmark<perf::small_vector<PlayerId, 8>>( "perf::small_vector<PlayerId, 8>", sizes );
+}
+
+int main() {
+    //////////////////////////////////////////////////////////////////////////
+    // static_vector
+    //////////////////////////////////////////////////////////////////////////
+    // a std::array with a size, capacity is fixed and nothing is ever allocated
+    perf::static_vector<PlayerId, 6> team = { 1, 2, 3 };
+    team.push_back( 4 );
+    // over capacity: push_back throws std::bad_alloc, try_emplace_back returns nullptr
+    while ( team.try_emplace_back( 5 ) != nullptr ) {
+    }
+    std::cout << team.size() << " " << team.full() << std::endl;
+
+    //////////////////////////////////////////////////////////////////////////
+    // small_vector
+    //////////////////////////////////////////////////////////////////////////
+    // inline up to N, then it moves to the heap and keeps growing
+    perf::small_vector<PlayerId, 4> squad = { 1, 2, 3, 4 };
+    std::cout << squad.is_inline() << " ";
+    squad.push_back( 5 );
+    std::cout << squad.is_inline() << std::endl;
+    // the fill value may be one of the elements, it is copied before they leave the inline storage
+    perf::small_vector<std::string, 2> names = { "ann", "bob" };
+    names.resize( 10, names[0] );
+    std::cout << names.is_inline() << " " << names[9] << std::endl;
+
+    benchmark_sizes( 1, 4 );
+    benchmark_sizes( 2, 8 );
+    benchmark_sizes( 8, 16 );
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Summary
+//////////////////////////////////////////////////////////////////////////
+/*
+A std::vector with three elements costs a heap allocation, a pointer chase on every access, and usually one or two reallocations on the way up.
+When the size is small and bounded, keep the elements inside the object.
+static_vector has a fixed capacity and never allocates. Exceeding its capacity is an error, so size it for the worst case.
+small_vector covers the common case inline and falls back to the heap for the rare big one.
+Every instance is as big as its inline capacity, so size small_vector's N for the typical case, not the largest one.
+Moving them moves the elements instead of a pointer, which is fine for a few ints.
+*/
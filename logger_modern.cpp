@@ -0,0 +1,92 @@
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "perf/async_logger.hpp"
+#include "perf/bench.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+// Synchronous logging
+//////////////////////////////////////////////////////////////////////////
+// this is print_once from variadic_modern.cpp plus the write
+// the caller pays for the formatting and the I/O every time
+template<typename... Args>
+inline void log_sync( std::FILE* out, const char* format, Args... args ) {
+    char text[256];
+    int n = std::snprintf( text, sizeof( text ), format, args... );
+    std::fwrite( text, 1, static_cast<size_t>( n ), out );
+    std::fflush( out );
+}
+
+int main() {
+    //////////////////////////////////////////////////////////////////////////
+    // Asynchronous logging
+    //////////////////////////////////////////////////////////////////////////
+    // the call site looks exactly like printf
+    // but only the raw argument bytes are copied on the calling thread
+    {
+        perf::async_logger log( stdout );
+        log.log( "hello %s, the answer is %d\n", "world", 42 );
+        log.log( "strings are copied: %s\n", std::string( "temporary" ) );
+
+        // every thread gets its own lock-free ring buffer, no contention between loggers
+        std::vector<std::thread> threads;
+        for ( int t = 0; t < 2; ++t ) {
+            threads.emplace_back( [&log, t] { log.log( "thread %d says %f\n", t, t * 1.5 ); } );
+        }
+        for ( auto& t : threads ) {
+            t.join();
+        }
+        // the destructor drains whatever is still buffered
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Caller-side latency
+    //////////////////////////////////////////////////////////////////////////
+    using clock = std::chrono::steady_clock;
+    const int count = 100'000;
+    std::vector<double> samples;
+    samples.reserve( count );
+
+    std::FILE* sync_out = std::tmpfile();
+    for ( int i = 0; i < count; ++i ) {
+        auto start = clock::now();
+        log_sync( sync_out, "order %d px %f side %s qty %lld\n", i, i * 0.25, "buy", 100ll * i );
+        samples.push_back( std::chrono::duration<double, std::nano>( clock::now() - start ).count() );
+    }
+    std::fclose( sync_out );
+    perf::print_latency( "snprintf + write", perf::summarize( samples ) );
+
+    samples.clear();
+    std::FILE* async_out = std::tmpfile();
+    std::uint64_t dropped = 0;
+    {
+        perf::async_logger log( async_out, std::size_t{ 8 } << 20 );
+        for ( int i = 0; i < count; ++i ) {
+            auto start = clock::now();
+            log.log( "order %d px %f side %s qty %lld\n", i, i * 0.25, "buy", 100ll * i );
+            samples.push_back( std::chrono::duration<double, std::nano>( clock::now() - start ).count() );
+        }
+        log.flush();
+        dropped = log.dropped();
+    }
+    std::fclose( async_out );
+    perf::print_latency( "async_logger", perf::summarize( samples ) );
+    std::cout << "dropped " << dropped << " of " << count << std::endl;
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Summary
+//////////////////////////////////////////////////////////////////////////
+/*
+Keep the hot thread's work to a memcpy: capture arguments as bytes, format somewhere else.
+
+The format string and the decoder are static, a record only carries two pointers and the arguments.
+Arguments are copied, so strings are safe to log, but the format string must outlive the logger.
+
+A full ring drops the message instead of blocking, size the ring for your burst and watch dropped().
+*/
@@ -0,0 +1,65 @@
+#include <iostream>
+#include <vector>
+#include <cstdio>
+
+#include "perf/find.hpp"
+#include "perf/bench.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+// Where the needle is
+//////////////////////////////////////////////////////////////////////////
+// position of the hit as a fraction of the range, 1 means not there at all
+double search_ms( std::vector<int>& results, double where, const perf::parallel_t* policy ) {
+    const int repeats = 10;
+    std::size_t hit = static_cast<std::size_t>( where * double( results.size() ) );
+    if ( hit < results.size() ) {
+        results[hit] = 1;
+    }
+    double ms = perf::time_ms( [&] {
+        for ( int i = 0; i < repeats; ++i ) {
+            bool any = policy != nullptr ? perf::any_equal( *policy, results, 1 ) : perf::any_equal( results, 1 );
+            perf::do_not_optimize( any );
+        }
+    } );
+    if ( hit < results.size() ) {
+        results[hit] = 0;
+    }
+    return ms / repeats;
+}
+
+void benchmark( std::vector<int>& results, const char* name, const perf::parallel_t* policy ) {
+    std::printf( "  %-20s %10.2f %10.2f %10.2f %10.2f\n", name, search_ms( results, 0.0001, policy ),
+                 search_ms( results, 0.01, policy ), search_ms( results, 0.5, policy ), search_ms( results, 1, policy ) );
+}
+
+int main() {
+    std::vector<int> results( 100'000'000 );
+    std::cout << perf::none_equal( perf::parallel, results, 1 ) << perf::all_equal( perf::parallel, results, 0 )
+              << std::endl;
+
+    std::printf( "any_equal over %zu ints, ms per search, hardware threads %u\n", results.size(),
+                 perf::hardware_threads() );
+    std::printf( "  %-20s %10s %10s %10s %10s\n", "", "hit 0.01%", "hit 1%", "hit 50%", "miss" );
+    benchmark( results, "sequential", nullptr );
+    benchmark( results, "perf::parallel", &perf::parallel );
+    for ( unsigned threads : { 1u, 2u, 4u, 8u } ) {
+        perf::thread_pool pool( threads - 1 );
+        auto policy = perf::parallel.on( pool );
+        char name[32];
+        std::snprintf( name, sizeof( name ), "on pool of %u", threads );
+        benchmark( results, name, &policy );
+    }
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Summary
+//////////////////////////////////////////////////////////////////////////
+/*
+A miss has to read everything, so more threads help until memory bandwidth runs out.
+A hit needs a way to stop the others: hand out blocks in order and skip any block past the best hit so far.
+Small blocks stop sooner, large blocks cost less to hand out; 64K elements is plenty of both.
+
+Waking a pool costs microseconds. Below a few blocks, search on the calling thread.
+Keep the pool alive between calls; creating threads per search would cost more than the search.
+*/
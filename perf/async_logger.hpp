@@ -0,0 +1,377 @@
+//  perf/async_logger.hpp  ---------------------------------------------------//
+
+//  Asynchronous binary logger.
+//
+//  The calling thread only copies its arguments as raw bytes into a
+//  per-thread single-producer/single-consumer ring buffer. The printf style
+//  formatting and the I/O happen later on a background thread.
+//
+//  Usage:
+//      perf::async_logger log( stdout );
+//      log.log( "order %d filled at %f\n", id, price );
+//
+//  Lifetime requirements:
+//  - the format string is stored by pointer, it must outlive the logger
+//    (string literals are the intended use)
+//  - C strings, std::string and std::string_view arguments are copied
+//  - every other argument must be trivially copyable and is copied bitwise
+
+#ifndef PERF_ASYNC_LOGGER_HPP
+#define PERF_ASYNC_LOGGER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace perf {
+
+namespace detail {
+
+//////////////////////////////////////////////////////////////////////////
+// Argument capture
+//////////////////////////////////////////////////////////////////////////
+// log_arg<T> knows how to size, encode and decode one argument type
+// the decoded type is whatever snprintf expects for that argument
+template< typename T >
+struct log_arg {
+    static_assert( std::is_trivially_copyable<T>::value,
+                   "async_logger arguments must be trivially copyable or strings" );
+    using decoded = T;
+
+    static std::size_t size( const T& ) { return sizeof( T ); }
+    static std::byte* encode( std::byte* p, const T& v ) {
+        std::memcpy( p, &v, sizeof( T ) );
+        return p + sizeof( T );
+    }
+    static const std::byte* decode( const std::byte* p, T& out ) {
+        std::memcpy( &out, p, sizeof( T ) );
+        return p + sizeof( T );
+    }
+};
+
+// strings are stored inline as [uint32 length][characters][null terminator]
+// and decode to a const char* pointing straight into the ring buffer
+struct log_string_arg {
+    using decoded = const char*;
+
+    static std::size_t size( std::string_view s ) { return sizeof( std::uint32_t ) + s.size() + 1; }
+    static std::byte* encode( std::byte* p, std::string_view s ) {
+        auto n = static_cast<std::uint32_t>( s.size() );
+        std::memcpy( p, &n, sizeof( n ) );
+        std::memcpy( p + sizeof( n ), s.data(), n );
+        p[sizeof( n ) + n] = std::byte{ 0 };
+        return p + sizeof( n ) + n + 1;
+    }
+    static const std::byte* decode( const std::byte* p, const char*& out ) {
+        std::uint32_t n;
+        std::memcpy( &n, p, sizeof( n ) );
+        out = reinterpret_cast<const char*>( p + sizeof( n ) );
+        return p + sizeof( n ) + n + 1;
+    }
+};
+
+template<> struct log_arg<const char*> : log_string_arg {};
+template<> struct log_arg<char*> : log_string_arg {};
+template<> struct log_arg<std::string> : log_string_arg {};
+template<> struct log_arg<std::string_view> : log_string_arg {};
+
+//////////////////////////////////////////////////////////////////////////
+// Format descriptor
+//////////////////////////////////////////////////////////////////////////
+// one static descriptor per argument type list, the record only stores a pointer to it
+struct log_descriptor {
+    int ( *format )( char* out, std::size_t length, const char* format, const std::byte* payload );
+};
+
+template< typename... Args >
+int format_record( char* out, std::size_t length, const char* format, const std::byte* payload ) {
+    std::tuple<typename log_arg<Args>::decoded...> values;
+    const std::byte* p = payload;
+    // decode in argument order, same pack expansion as for_each_argument
+    std::apply( [&p]( auto&... v ) { ( ( p = log_arg<Args>::decode( p, v ) ), ... ); }, values );
+    (void)p;
+    return std::apply( [&]( auto... v ) { return std::snprintf( out, length, format, v... ); }, values );
+}
+
+template< typename... Args >
+struct log_descriptor_for {
+    static constexpr log_descriptor value{ &format_record<Args...> };
+};
+
+struct record_header {
+    std::uint32_t size;             // whole record including the header, multiple of 8
+    const log_descriptor* desc;     // nullptr marks padding up to the end of the buffer
+    const char* format;
+};
+
+constexpr std::size_t round_up8( std::size_t n ) { return ( n + 7 ) & ~std::size_t{ 7 }; }
+
+//////////////////////////////////////////////////////////////////////////
+// Single producer / single consumer byte ring
+//////////////////////////////////////////////////////////////////////////
+// records never wrap, if a record does not fit before the end of the buffer
+// the producer pads to the end and starts over at offset 0
+class spsc_ring {
+public:
+    explicit spsc_ring( std::size_t capacity )
+        : m_storage( capacity / sizeof( std::uint64_t ) ), m_capacity( capacity ) {}
+
+    std::size_t capacity() const { return m_capacity; }
+
+    // producer: reserve `bytes` contiguous bytes, call fill on them and publish
+    template< typename F >
+    bool try_write( std::size_t bytes, F&& fill ) {
+        std::size_t head = m_head.load( std::memory_order_relaxed );
+        std::size_t offset = head & ( m_capacity - 1 );
+        std::size_t contiguous = m_capacity - offset;
+        std::size_t skip = contiguous < bytes ? contiguous : 0;
+        std::size_t needed = skip + bytes;
+
+        if ( m_capacity - ( head - m_cached_tail ) < needed ) {
+            m_cached_tail = m_tail.load( std::memory_order_acquire );
+            if ( m_capacity - ( head - m_cached_tail ) < needed ) {
+                return false;
+            }
+        }
+        if ( skip != 0 ) {
+            if ( skip >= sizeof( record_header ) ) {
+                new ( data() + offset ) record_header{ static_cast<std::uint32_t>( skip ), nullptr, nullptr };
+            }
+            offset = 0;
+        }
+        fill( data() + offset );
+        m_head.store( head + needed, std::memory_order_release );
+        return true;
+    }
+
+    // consumer: call f for every published record, returns how many were consumed
+    template< typename F >
+    std::size_t drain( F&& f ) {
+        std::size_t tail = m_tail.load( std::memory_order_relaxed );
+        std::size_t head = m_head.load( std::memory_order_acquire );
+        std::size_t count = 0;
+        while ( tail != head ) {
+            std::size_t offset = tail & ( m_capacity - 1 );
+            std::size_t contiguous = m_capacity - offset;
+            if ( contiguous < sizeof( record_header ) ) {
+                // too small for even a padding header, both sides skip it implicitly
+                tail += contiguous;
+                continue;
+            }
+            auto* header = reinterpret_cast<const record_header*>( data() + offset );
+            if ( header->desc != nullptr ) {
+                f( *header );
+                ++count;
+            }
+            tail += header->size;
+        }
+        m_tail.store( tail, std::memory_order_release );
+        return count;
+    }
+
+    bool empty() const {
+        return m_head.load( std::memory_order_acquire ) == m_tail.load( std::memory_order_acquire );
+    }
+
+private:
+    std::byte* data() { return reinterpret_cast<std::byte*>( m_storage.data() ); }
+
+    std::vector<std::uint64_t> m_storage;
+    std::size_t m_capacity;
+
+    // producer and consumer indices live on their own cache lines
+    alignas( 64 ) std::atomic<std::size_t> m_head{ 0 };
+    std::size_t m_cached_tail = 0;
+    alignas( 64 ) std::atomic<std::size_t> m_tail{ 0 };
+};
+
+} // namespace detail
+
+//////////////////////////////////////////////////////////////////////////
+// async_logger
+//////////////////////////////////////////////////////////////////////////
+// thread-safe: any number of threads may log concurrently, each gets its own ring
+// a full ring drops the message rather than blocking the caller, see dropped()
+class async_logger {
+public:
+    explicit async_logger( std::FILE* out, std::size_t ring_bytes_per_thread = std::size_t{ 1 } << 20 )
+        : m_out( out )
+        , m_ring_bytes( round_up_pow2( ring_bytes_per_thread ) )
+        , m_id( next_id() )
+        , m_worker( [this] { run(); } ) {}
+
+    async_logger( const async_logger& ) = delete;
+    async_logger& operator=( const async_logger& ) = delete;
+
+    // drains everything that was logged before destruction
+    ~async_logger() {
+        {
+            std::lock_guard<std::mutex> _{ m_wake_mutex };
+            m_running.store( false, std::memory_order_release );
+        }
+        m_wake.notify_one();
+        m_worker.join();
+        std::fflush( m_out );
+    }
+
+    template< typename... Args >
+    bool log( const char* format, const Args&... args ) {
+        using descriptor = detail::log_descriptor_for<std::decay_t<Args>...>;
+        std::size_t payload = ( std::size_t{ 0 } + ... + detail::log_arg<std::decay_t<Args>>::size( args ) );
+        std::size_t bytes = detail::round_up8( sizeof( detail::record_header ) + payload );
+
+        thread_ring& local = local_ring();
+        bool written = bytes <= m_ring_bytes && local.ring.try_write( bytes, [&]( std::byte* p ) {
+            new ( p ) detail::record_header{ static_cast<std::uint32_t>( bytes ), &descriptor::value, format };
+            std::byte* out = p + sizeof( detail::record_header );
+            ( ( out = detail::log_arg<std::decay_t<Args>>::encode( out, args ) ), ... );
+        } );
+        if ( !written ) {
+            m_dropped.fetch_add( 1, std::memory_order_relaxed );
+        }
+        return written;
+    }
+
+    // blocks until everything logged so far has been written and flushed
+    void flush() {
+        for ( ;; ) {
+            bool empty = true;
+            {
+                std::lock_guard<std::mutex> _{ m_rings_mutex };
+                for ( auto& r : m_rings ) {
+                    empty = empty && r->ring.empty();
+                }
+            }
+            if ( empty ) {
+                break;
+            }
+            m_wake.notify_one();
+            std::this_thread::yield();
+        }
+        std::fflush( m_out );
+    }
+
+    std::uint64_t dropped() const { return m_dropped.load( std::memory_order_relaxed ); }
+
+private:
+    struct thread_ring {
+        explicit thread_ring( std::size_t bytes ) : ring( bytes ) {}
+        detail::spsc_ring ring;
+        std::atomic<bool> retired{ false };
+    };
+
+    // every thread remembers the rings it owns, one per logger it has written to
+    struct thread_rings {
+        std::vector<std::pair<std::uint64_t, std::shared_ptr<thread_ring>>> entries;
+        ~thread_rings() {
+            for ( auto& e : entries ) {
+                e.second->retired.store( true, std::memory_order_release );
+            }
+        }
+    };
+
+    thread_ring& local_ring() {
+        thread_local thread_rings rings;
+        for ( auto& e : rings.entries ) {
+            if ( e.first == m_id ) {
+                return *e.second;
+            }
+        }
+        auto r = std::make_shared<thread_ring>( m_ring_bytes );
+        {
+            std::lock_guard<std::mutex> _{ m_rings_mutex };
+            m_rings.push_back( r );
+        }
+        rings.entries.emplace_back( m_id, r );
+        return *r;
+    }
+
+    void run() {
+        std::vector<char> text( 1024 );
+        std::vector<std::shared_ptr<thread_ring>> rings;
+        auto write_record = [&]( const detail::record_header& h ) {
+            auto payload = reinterpret_cast<const std::byte*>( &h + 1 );
+            int n = h.desc->format( text.data(), text.size(), h.format, payload );
+            if ( n >= 0 && static_cast<std::size_t>( n ) >= text.size() ) {
+                text.resize( static_cast<std::size_t>( n ) + 1 );
+                n = h.desc->format( text.data(), text.size(), h.format, payload );
+            }
+            if ( n > 0 ) {
+                std::fwrite( text.data(), 1, static_cast<std::size_t>( n ), m_out );
+            }
+        };
+
+        for ( ;; ) {
+            // read the flag before draining so one full pass always follows shutdown
+            bool running = m_running.load( std::memory_order_acquire );
+            {
+                std::lock_guard<std::mutex> _{ m_rings_mutex };
+                rings = m_rings;
+            }
+            std::size_t written = 0;
+            for ( auto& r : rings ) {
+                bool retired = r->retired.load( std::memory_order_acquire );
+                written += r->ring.drain( write_record );
+                if ( retired ) {
+                    std::lock_guard<std::mutex> _{ m_rings_mutex };
+                    m_rings.erase( std::find( m_rings.begin(), m_rings.end(), r ) );
+                }
+            }
+            if ( written == 0 ) {
+                if ( !running ) {
+                    break;
+                }
+                std::fflush( m_out );
+                std::unique_lock<std::mutex> lock{ m_wake_mutex };
+                m_wake.wait_for( lock, std::chrono::microseconds( 200 ),
+                                 [this] { return !m_running.load( std::memory_order_acquire ); } );
+            }
+        }
+    }
+
+    static std::size_t round_up_pow2( std::size_t n ) {
+        std::size_t p = 4096;
+        while ( p < n ) {
+            p <<= 1;
+        }
+        return p;
+    }
+
+    static std::uint64_t next_id() {
+        static std::atomic<std::uint64_t> id{ 0 };
+        return ++id;
+    }
+
+    std::FILE* m_out;
+    std::size_t m_ring_bytes;
+    std::uint64_t m_id;
+
+    std::mutex m_rings_mutex;
+    std::vector<std::shared_ptr<thread_ring>> m_rings;
+
+    std::atomic<std::uint64_t> m_dropped{ 0 };
+    std::atomic<bool> m_running{ true };
+    std::mutex m_wake_mutex;
+    std::condition_variable m_wake;
+
+    // declared last, the worker starts in the constructor and uses everything above
+    std::thread m_worker;
+};
+
+} // namespace perf
+
+#endif  // PERF_ASYNC_LOGGER_HPP
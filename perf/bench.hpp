@@ -0,0 +1,84 @@
+//  perf/bench.hpp  ----------------------------------------------------------//
+
+//  Tiny helpers shared by the benchmark sections of the *_modern.cpp examples.
+//  Nothing clever here on purpose: steady_clock, a best-of-N loop and sorted
+//  percentiles. If you need more than this grab google benchmark.
+
+#ifndef PERF_BENCH_HPP
+#define PERF_BENCH_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+namespace perf {
+
+//////////////////////////////////////////////////////////////////////////
+// do_not_optimize
+//////////////////////////////////////////////////////////////////////////
+// keep the optimizer from deleting the work we are trying to measure
+template< typename T >
+inline void do_not_optimize( T const& value ) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile( "" : : "r,m"( value ) : "memory" );
+#else
+    static volatile char sink;
+    sink = *reinterpret_cast<const volatile char*>( &value );
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Timing
+//////////////////////////////////////////////////////////////////////////
+// best wall-clock time of `repeats` runs of f, in milliseconds
+template< typename F >
+double time_ms( F&& f, int repeats = 5 ) {
+    using clock = std::chrono::steady_clock;
+    double best = 1e300;
+    for ( int i = 0; i < repeats; ++i ) {
+        auto start = clock::now();
+        f();
+        std::chrono::duration<double, std::milli> elapsed = clock::now() - start;
+        best = std::min( best, elapsed.count() );
+    }
+    return best;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Latency distribution
+//////////////////////////////////////////////////////////////////////////
+struct latency_summary {
+    double p50 = 0;
+    double p99 = 0;
+    double p999 = 0;
+    double max = 0;
+};
+
+// sorts the samples in place
+inline latency_summary summarize( std::vector<double>& samples ) {
+    latency_summary s;
+    if ( samples.empty() ) {
+        return s;
+    }
+    std::sort( samples.begin(), samples.end() );
+    auto at = [&]( double q ) {
+        auto i = static_cast<std::size_t>( q * static_cast<double>( samples.size() - 1 ) );
+        return samples[i];
+    };
+    s.p50 = at( 0.50 );
+    s.p99 = at( 0.99 );
+    s.p999 = at( 0.999 );
+    s.max = samples.back();
+    return s;
+}
+
+inline void print_latency( const char* name, const latency_summary& s, const char* unit = "ns" ) {
+    std::printf( "%-28s p50 %8.1f%s  p99 %8.1f%s  p99.9 %8.1f%s  max %10.1f%s\n",
+                 name, s.p50, unit, s.p99, unit, s.p999, unit, s.max, unit );
+}
+
+} // namespace perf
+
+#endif  // PERF_BENCH_HPP
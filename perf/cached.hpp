@@ -0,0 +1,196 @@
+//  perf/cached.hpp  ---------------------------------------------------------//
+
+//  Lazily computed values that const member functions can fill in safely.
+//
+//  The qualifiers_modern.cpp recipe, a mutable std::mutex next to a mutable
+//  cache, takes the lock on every read. Readers on different cores then
+//  bounce the mutex's cache line between them even when the value has been
+//  computed long ago. Both types here make the hit path lock-free:
+//
+//  cached<T>          one acquire load of a state byte, then the value.
+//                     The first caller computes, concurrent callers wait.
+//                     Thread-compatible like the rest of the object: reset()
+//                     and assignment need exclusive access.
+//
+//  seqlock_cached<T>  for trivially copyable values larger than a word that
+//                     also get replaced while others read. Readers never
+//                     write shared memory, they copy the value and retry if
+//                     a writer got in the way. store() and reset() are safe
+//                     to call concurrently with readers.
+//
+//      class Widget {
+//          int sum() const { return m_sum.get( [&] { return std::accumulate( ... ); } ); }
+//          perf::cached<int> m_sum;   // mutable inside
+//      };
+
+#ifndef PERF_CACHED_HPP
+#define PERF_CACHED_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "simd.hpp"
+
+namespace perf {
+
+//////////////////////////////////////////////////////////////////////////
+// cached
+//////////////////////////////////////////////////////////////////////////
+template< typename T >
+class cached {
+public:
+    cached() = default;
+    cached( const cached& ) = delete;
+    cached& operator=( const cached& ) = delete;
+    ~cached() { reset(); }
+
+    // the cached value, computing it with compute() if empty
+    // if compute throws the cache stays empty and the next caller tries again
+    template< typename F >
+    const T& get( F&& compute ) const {
+        if ( m_state.load( std::memory_order_acquire ) != ready ) {
+            fill( std::forward<F>( compute ) );
+        }
+        return value();
+    }
+
+    bool has_value() const noexcept { return m_state.load( std::memory_order_acquire ) == ready; }
+
+    // not thread-safe, call from non-const members the way you'd modify any other member
+    void reset() noexcept {
+        if ( m_state.load( std::memory_order_relaxed ) == ready ) {
+            value().~T();
+            m_state.store( empty, std::memory_order_relaxed );
+        }
+    }
+
+private:
+    enum : std::uint8_t { empty, computing, ready };
+
+    template< typename F >
+    void fill( F&& compute ) const {
+        for ( ;; ) {
+            std::uint8_t state = empty;
+            if ( m_state.compare_exchange_strong( state, computing, std::memory_order_acquire ) ) {
+                break;
+            }
+            if ( state == ready ) {
+                return;
+            }
+            // someone else is computing, the wait is at most one compute()
+            for ( int spins = 0; m_state.load( std::memory_order_acquire ) == computing; ++spins ) {
+                if ( spins < 64 ) {
+                    cpu_relax();
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        try {
+            ::new ( static_cast<void*>( &m_storage ) ) T( compute() );
+        } catch ( ... ) {
+            m_state.store( empty, std::memory_order_release );
+            throw;
+        }
+        m_state.store( ready, std::memory_order_release );
+    }
+
+    T& value() const noexcept { return *std::launder( reinterpret_cast<T*>( &m_storage ) ); }
+
+    mutable std::atomic<std::uint8_t> m_state{ empty };
+    mutable std::aligned_storage_t<sizeof( T ), alignof( T )> m_storage;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// seqlock_cached
+//////////////////////////////////////////////////////////////////////////
+// the value lives in relaxed atomic words so a torn read is a retry, not undefined behavior
+template< typename T >
+class seqlock_cached {
+    static_assert( std::is_trivially_copyable<T>::value, "seqlock_cached copies T byte-wise" );
+
+public:
+    seqlock_cached() = default;
+    seqlock_cached( const seqlock_cached& ) = delete;
+    seqlock_cached& operator=( const seqlock_cached& ) = delete;
+
+    // the cached value, computing and publishing it if empty
+    // racing callers may each compute, the last one to publish wins
+    template< typename F >
+    T get( F&& compute ) const {
+        T result;
+        if ( !try_load( result ) ) {
+            result = compute();
+            publish( result, true );
+        }
+        return result;
+    }
+
+    // copies the value out if there is one
+    bool try_load( T& out ) const noexcept {
+        std::array<std::uint64_t, word_count> words;
+        for ( ;; ) {
+            std::uint64_t before = m_sequence.load( std::memory_order_acquire );
+            if ( before & 1 ) {
+                cpu_relax();
+                continue;
+            }
+            for ( std::size_t i = 0; i < word_count; ++i ) {
+                words[i] = m_words[i].load( std::memory_order_relaxed );
+            }
+            std::atomic_thread_fence( std::memory_order_acquire );
+            if ( m_sequence.load( std::memory_order_relaxed ) == before ) {
+                break;
+            }
+        }
+        if ( words[word_count - 1] == 0 ) {
+            return false;
+        }
+        std::memcpy( &out, words.data(), sizeof( T ) );
+        return true;
+    }
+
+    // thread-safe, writers serialize among themselves
+    void store( const T& value ) const noexcept { publish( value, true ); }
+    void reset() const noexcept { publish( T{}, false ); }
+
+private:
+    // the value rounded up to whole words, plus a last word for "has value"
+    static constexpr std::size_t word_count = ( sizeof( T ) + 7 ) / 8 + 1;
+
+    void publish( const T& value, bool valid ) const noexcept {
+        std::array<std::uint64_t, word_count> words{};
+        std::memcpy( words.data(), &value, sizeof( T ) );
+        words[word_count - 1] = valid ? 1 : 0;
+
+        std::uint64_t sequence = m_sequence.load( std::memory_order_relaxed );
+        for ( ;; ) {
+            if ( ( sequence & 1 ) == 0 &&
+                 m_sequence.compare_exchange_weak( sequence, sequence + 1, std::memory_order_relaxed ) ) {
+                break;
+            }
+            cpu_relax();
+            sequence = m_sequence.load( std::memory_order_relaxed );
+        }
+        // odd sequence must be visible before any of the words change
+        std::atomic_thread_fence( std::memory_order_release );
+        for ( std::size_t i = 0; i < word_count; ++i ) {
+            m_words[i].store( words[i], std::memory_order_relaxed );
+        }
+        m_sequence.store( sequence + 2, std::memory_order_release );
+    }
+
+    mutable std::atomic<std::uint64_t> m_sequence{ 0 };
+    mutable std::array<std::atomic<std::uint64_t>, word_count> m_words{};
+};
+
+} // namespace perf
+
+#endif  // PERF_CACHED_HPP
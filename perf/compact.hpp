@@ -0,0 +1,143 @@
+//  perf/compact.hpp  --------------------------------------------------------//
+
+//  compact_if: a drop-in std::remove_if for contiguous ranges of arithmetic types.
+//
+//      int* new_last = perf::compact_if( values.data(), values.data() + values.size(), is_even );
+//
+//  or the whole erase-remove idiom in one call: perf::erase_if( values, is_even ).
+//
+//  Same contract as std::remove_if: elements for which pred is true are
+//  removed, the kept elements stay in order, and the new end is returned.
+//  Unlike std::remove_if there is no branch per element. The predicate is
+//  evaluated for a whole block into a bit mask, then the kept elements are
+//  packed with one SIMD compress:
+//  - AVX-512 (when compiled with it) has a native compress instruction
+//  - AVX2 uses a lookup table of lane permutations indexed by the mask
+//  - everything else uses a branch-free scalar loop
+//  The predicate is called exactly once per element, so keep it cheap and
+//  side-effect free; an inline lambda or function the compiler can see works best.
+
+#ifndef PERF_COMPACT_HPP
+#define PERF_COMPACT_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+
+#include "simd.hpp"
+
+namespace perf {
+
+namespace detail {
+
+template< typename T, typename Pred >
+T* compact_if_scalar( const T* first, const T* last, T* out, Pred& pred ) {
+    for ( ; first != last; ++first ) {
+        // always store, only advance when the element is kept
+        T x = *first;
+        *out = x;
+        out += !pred( x );
+    }
+    return out;
+}
+
+// keep mask for `Lanes` consecutive elements, bit i set when element i survives
+template< std::size_t Lanes, typename T, typename Pred >
+std::uint32_t keep_mask( const T* p, Pred& pred ) {
+    std::uint32_t mask = 0;
+    for ( std::size_t i = 0; i < Lanes; ++i ) {
+        mask |= static_cast<std::uint32_t>( !pred( p[i] ) ) << i;
+    }
+    return mask;
+}
+
+#if PERF_AVX2
+// for every 8 bit keep mask, the source lanes of the kept elements packed to the front
+// one byte per lane, expanded to a permutevar8x32 index vector with cvtepu8_epi32
+constexpr std::array<std::uint64_t, 256> make_compress_table_8x32() {
+    std::array<std::uint64_t, 256> table{};
+    for ( std::uint32_t mask = 0; mask < 256; ++mask ) {
+        std::uint64_t entry = 0;
+        int out = 0;
+        for ( std::uint64_t lane = 0; lane < 8; ++lane ) {
+            if ( mask & ( 1u << lane ) ) {
+                entry |= lane << ( 8 * out++ );
+            }
+        }
+        table[mask] = entry;
+    }
+    return table;
+}
+
+inline constexpr std::array<std::uint64_t, 256> compress_table_8x32 = make_compress_table_8x32();
+
+inline __m256i compress_epi32( __m256i v, std::uint32_t mask ) {
+#if defined(__AVX512F__) && defined(__AVX512VL__)
+    return _mm256_maskz_compress_epi32( static_cast<__mmask8>( mask ), v );
+#else
+    __m128i bytes = _mm_cvtsi64_si128( static_cast<long long>( compress_table_8x32[mask] ) );
+    return _mm256_permutevar8x32_epi32( v, _mm256_cvtepu8_epi32( bytes ) );
+#endif
+}
+
+// 64-bit elements are pairs of 32-bit lanes, reuse the 8 lane table with doubled masks
+inline __m256i compress_epi64( __m256i v, std::uint32_t mask ) {
+#if defined(__AVX512F__) && defined(__AVX512VL__)
+    return _mm256_maskz_compress_epi64( static_cast<__mmask8>( mask ), v );
+#else
+    std::uint32_t pairs = 0;
+    for ( int i = 0; i < 4; ++i ) {
+        pairs |= ( ( mask >> i ) & 1u ) * ( 3u << ( 2 * i ) );
+    }
+    return compress_epi32( v, pairs );
+#endif
+}
+
+template< typename T, typename Pred >
+T* compact_if_avx2( const T* first, const T* last, T* out, Pred& pred ) {
+    constexpr std::size_t lanes = 32 / sizeof( T );
+    for ( ; last - first >= static_cast<std::ptrdiff_t>( lanes ); first += lanes ) {
+        std::uint32_t mask = keep_mask<lanes>( first, pred );
+        __m256i v = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( first ) );
+        __m256i packed = sizeof( T ) == 4 ? compress_epi32( v, mask ) : compress_epi64( v, mask );
+        // a full store is safe in place: out never passes first, and these lanes are already loaded
+        _mm256_storeu_si256( reinterpret_cast<__m256i*>( out ), packed );
+        out += popcount( mask );
+    }
+    return compact_if_scalar( first, last, out, pred );
+}
+#endif
+
+} // namespace detail
+
+//////////////////////////////////////////////////////////////////////////
+// compact_if
+//////////////////////////////////////////////////////////////////////////
+// removes the elements for which pred is true, returns the new end
+template< typename T, typename Pred >
+T* compact_if( T* first, T* last, Pred pred ) {
+    static_assert( std::is_arithmetic<T>::value, "compact_if works on arithmetic element types" );
+#if PERF_AVX2
+    if constexpr ( sizeof( T ) == 4 || sizeof( T ) == 8 ) {
+        return detail::compact_if_avx2( first, last, first, pred );
+    }
+#endif
+    return detail::compact_if_scalar( first, last, first, pred );
+}
+
+// the whole erase-remove idiom, like C++20 std::erase_if; returns how many were removed
+template< typename Container, typename Pred >
+std::size_t erase_if( Container& c, Pred pred ) {
+    auto first = std::data( c );
+    auto last = first + std::size( c );
+    auto new_last = compact_if( first, last, pred );
+    c.erase( c.begin() + ( new_last - first ), c.end() );
+    return static_cast<std::size_t>( last - new_last );
+}
+
+} // namespace perf
+
+#endif  // PERF_COMPACT_HPP
@@ -0,0 +1,216 @@
+//  perf/compare.hpp  --------------------------------------------------------//
+
+//  Element-wise equality and three-way lexicographic compare for std::array
+//  and contiguous ranges, the values == values2 and values < values2 of
+//  arrays_modern.cpp for large arrays.
+//
+//  Both come down to finding the first index where the elements differ. For
+//  arithmetic and enum elements the AVX2 kernel compares 32 bytes per
+//  instruction, four registers per iteration, and only looks for the lane
+//  once a combined mask shows a difference. The tail is one more load that
+//  overlaps the last full register instead of a scalar loop.
+//
+//      bool same = perf::equal( record, other );
+//      int order = perf::compare_three_way( record, other );   // <0, 0, >0
+//      std::sort( records.begin(), records.end(), perf::lexicographic_less{} );
+//
+//  Results match std::equal and std::lexicographical_compare, including
+//  floating point: NaN is never equal, and a pair that is neither less nor
+//  greater does not decide the order. Every other element type, or a pair of
+//  different element types, goes through the standard algorithms.
+
+#ifndef PERF_COMPARE_HPP
+#define PERF_COMPARE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+#include "find.hpp"
+#include "simd.hpp"
+
+namespace perf {
+
+namespace detail {
+
+//////////////////////////////////////////////////////////////////////////
+// Eligibility
+//////////////////////////////////////////////////////////////////////////
+template< typename T, typename = void >
+struct simd_comparable : std::bool_constant<simd_searchable<T>> {};
+
+// enums compare as their underlying integer
+template< typename T >
+struct simd_comparable<T, std::enable_if_t<std::is_enum<T>::value>>
+    : std::bool_constant<simd_searchable<std::underlying_type_t<T>>> {};
+
+template< typename It1, typename It2 >
+constexpr bool is_pointer_pair_to_comparable =
+    std::is_pointer<It1>::value && std::is_pointer<It2>::value &&
+    std::is_same<std::remove_cv_t<std::remove_pointer_t<It1>>, std::remove_cv_t<std::remove_pointer_t<It2>>>::value &&
+    simd_comparable<std::remove_cv_t<std::remove_pointer_t<It1>>>::value;
+
+//////////////////////////////////////////////////////////////////////////
+// Kernels
+//////////////////////////////////////////////////////////////////////////
+template< typename T >
+std::size_t mismatch_scalar( const T* a, const T* b, std::size_t n ) noexcept {
+    std::size_t i = 0;
+    while ( i < n && a[i] == b[i] ) {
+        ++i;
+    }
+    return i;
+}
+
+#if PERF_AVX2
+// index of the first i where !( a[i] == b[i] ), or n
+template< typename T >
+std::size_t mismatch_avx2( const T* a, const T* b, std::size_t n ) noexcept {
+    constexpr std::size_t lanes = 32 / sizeof( T );
+    auto load = []( const T* p ) { return _mm256_loadu_si256( reinterpret_cast<const __m256i*>( p ) ); };
+    auto same = [&]( std::size_t i ) { return equal_lanes<T>( load( a + i ), load( b + i ) ); };
+    // bit per byte, set where the lanes differ
+    auto differ = []( __m256i eq ) { return ~static_cast<std::uint32_t>( _mm256_movemask_epi8( eq ) ); };
+
+    if ( n < lanes ) {
+        return mismatch_scalar( a, b, n );
+    }
+    std::size_t i = 0;
+    for ( ; i + 4 * lanes <= n; i += 4 * lanes ) {
+        __m256i e0 = same( i );
+        __m256i e1 = same( i + lanes );
+        __m256i e2 = same( i + 2 * lanes );
+        __m256i e3 = same( i + 3 * lanes );
+        if ( differ( _mm256_and_si256( _mm256_and_si256( e0, e1 ), _mm256_and_si256( e2, e3 ) ) ) != 0 ) {
+            const __m256i e[4] = { e0, e1, e2, e3 };
+            for ( std::size_t k = 0;; ++k ) {
+                if ( std::uint32_t mask = differ( e[k] ) ) {
+                    return i + k * lanes + count_trailing_zeros( mask ) / sizeof( T );
+                }
+            }
+        }
+    }
+    for ( ; i + lanes <= n; i += lanes ) {
+        if ( std::uint32_t mask = differ( same( i ) ) ) {
+            return i + count_trailing_zeros( mask ) / sizeof( T );
+        }
+    }
+    if ( i < n ) {
+        // the last register overlaps lanes already known to be equal
+        std::size_t last = n - lanes;
+        if ( std::uint32_t mask = differ( same( last ) ) ) {
+            return last + count_trailing_zeros( mask ) / sizeof( T );
+        }
+    }
+    return n;
+}
+#endif
+
+template< typename T >
+std::size_t mismatch_contiguous( const T* a, const T* b, std::size_t n ) noexcept {
+#if PERF_AVX2
+    return mismatch_avx2( a, b, n );
+#else
+    return mismatch_scalar( a, b, n );
+#endif
+}
+
+// -1, 0 or 1 from the first pair that is ordered, then from the lengths
+template< typename T >
+int compare_three_way_contiguous( const T* a, std::size_t na, const T* b, std::size_t nb ) noexcept {
+    std::size_t n = std::min( na, nb );
+    for ( std::size_t i = 0; ( i += mismatch_contiguous( a + i, b + i, n - i ) ) < n; ++i ) {
+        if ( a[i] < b[i] ) {
+            return -1;
+        }
+        if ( b[i] < a[i] ) {
+            return 1;
+        }
+        // unordered, NaN: keep going like std::lexicographical_compare
+    }
+    return na < nb ? -1 : nb < na ? 1 : 0;
+}
+
+} // namespace detail
+
+//////////////////////////////////////////////////////////////////////////
+// equal
+//////////////////////////////////////////////////////////////////////////
+// std::equal( first1, last1, first2, last2 )
+template< typename InputIt1, typename InputIt2 >
+bool equal( InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2 ) {
+    if constexpr ( detail::is_pointer_pair_to_comparable<InputIt1, InputIt2> ) {
+        auto n = static_cast<std::size_t>( last1 - first1 );
+        return n == static_cast<std::size_t>( last2 - first2 ) && detail::mismatch_contiguous( first1, first2, n ) == n;
+    } else {
+        return std::equal( first1, last1, first2, last2 );
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// compare_three_way
+//////////////////////////////////////////////////////////////////////////
+// negative, zero or positive as [first1, last1) orders before, with or after [first2, last2)
+// the C++20 std::lexicographical_compare_three_way, with an int in place of a comparison category
+template< typename InputIt1, typename InputIt2 >
+int compare_three_way( InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2 ) {
+    if constexpr ( detail::is_pointer_pair_to_comparable<InputIt1, InputIt2> ) {
+        return detail::compare_three_way_contiguous( first1, static_cast<std::size_t>( last1 - first1 ), first2,
+                                                     static_cast<std::size_t>( last2 - first2 ) );
+    } else {
+        for ( ; first1 != last1 && first2 != last2; ++first1, ++first2 ) {
+            if ( *first1 < *first2 ) {
+                return -1;
+            }
+            if ( *first2 < *first1 ) {
+                return 1;
+            }
+        }
+        return first1 != last1 ? 1 : first2 != last2 ? -1 : 0;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Range overloads
+//////////////////////////////////////////////////////////////////////////
+template< typename Range1, typename Range2 >
+bool equal( Range1&& lhs, Range2&& rhs ) {
+    return detail::with_bounds( lhs, [&rhs]( auto first1, auto last1 ) {
+        return detail::with_bounds( rhs, [first1, last1]( auto first2, auto last2 ) {
+            return perf::equal( first1, last1, first2, last2 );
+        } );
+    } );
+}
+
+template< typename Range1, typename Range2 >
+int compare_three_way( Range1&& lhs, Range2&& rhs ) {
+    return detail::with_bounds( lhs, [&rhs]( auto first1, auto last1 ) {
+        return detail::with_bounds( rhs, [first1, last1]( auto first2, auto last2 ) {
+            return perf::compare_three_way( first1, last1, first2, last2 );
+        } );
+    } );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Function objects
+//////////////////////////////////////////////////////////////////////////
+// for std::unique, std::sort, std::map and friends over containers of records
+struct lexicographic_equal {
+    template< typename Range1, typename Range2 >
+    bool operator()( const Range1& lhs, const Range2& rhs ) const {
+        return perf::equal( lhs, rhs );
+    }
+};
+
+struct lexicographic_less {
+    template< typename Range1, typename Range2 >
+    bool operator()( const Range1& lhs, const Range2& rhs ) const {
+        return perf::compare_three_way( lhs, rhs ) < 0;
+    }
+};
+
+} // namespace perf
+
+#endif  // PERF_COMPARE_HPP
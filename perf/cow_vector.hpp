@@ -0,0 +1,237 @@
+//  perf/cow_vector.hpp  -----------------------------------------------------//
+
+//  A copy-on-write vector made of refcounted fixed-size chunks.
+//
+//  Copying a cow_vector is O(1): the copy shares the chunk table and every
+//  chunk. A write first makes the table unique (one pointer per chunk), then
+//  the chunk it touches (one chunk's worth of elements), never the rest. So a
+//  point-in-time snapshot of a large payload costs a pointer copy, and keeping
+//  it alive while the original keeps changing costs one chunk per chunk
+//  actually written.
+//
+//      perf::cow_vector<int> data( big_vector );
+//      auto snapshot = data;            // O(1), hand it to a reader thread
+//      data.set( 17, 42 );              // copies the table and one 4KB chunk
+//
+//  Thread safety is that of a value type: different cow_vector objects may be
+//  used from different threads even when they share chunks, a single object
+//  needs external synchronization for writes (see the example).
+
+#ifndef PERF_COW_VECTOR_HPP
+#define PERF_COW_VECTOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace perf {
+
+namespace detail {
+
+// largest power of two that keeps a chunk within a 4KB page
+template< typename T >
+constexpr std::size_t default_cow_chunk() {
+    std::size_t n = 1;
+    while ( n * 2 * sizeof( T ) <= 4096 ) {
+        n *= 2;
+    }
+    return n;
+}
+
+// only owner of p? The fence pairs with the release in other owners' decrements,
+// so their last reads happen before our writes
+template< typename P >
+bool is_unique( const std::shared_ptr<P>& p ) noexcept {
+    if ( p.use_count() != 1 ) {
+        return false;
+    }
+    std::atomic_thread_fence( std::memory_order_acquire );
+    return true;
+}
+
+} // namespace detail
+
+template< typename T, std::size_t ChunkSize = detail::default_cow_chunk<T>() >
+class cow_vector {
+    static_assert( ChunkSize > 0 && ( ChunkSize & ( ChunkSize - 1 ) ) == 0, "ChunkSize must be a power of two" );
+
+    using chunk = std::vector<T>;
+    using chunk_table = std::vector<std::shared_ptr<chunk>>;
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    static constexpr size_type chunk_size = ChunkSize;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator() = default;
+        reference operator*() const noexcept { return ( *m_owner )[m_index]; }
+        pointer operator->() const noexcept { return &**this; }
+        const_iterator& operator++() noexcept {
+            ++m_index;
+            return *this;
+        }
+        const_iterator operator++( int ) noexcept {
+            auto old = *this;
+            ++m_index;
+            return old;
+        }
+        friend bool operator==( const const_iterator& a, const const_iterator& b ) noexcept { return a.m_index == b.m_index; }
+        friend bool operator!=( const const_iterator& a, const const_iterator& b ) noexcept { return a.m_index != b.m_index; }
+
+    private:
+        friend class cow_vector;
+        const_iterator( const cow_vector* owner, size_type index ) noexcept : m_owner( owner ), m_index( index ) {}
+
+        const cow_vector* m_owner = nullptr;
+        size_type m_index = 0;
+    };
+
+    cow_vector() noexcept : m_table( empty_table() ) {}
+
+    template< typename It >
+    cow_vector( It first, It last ) : cow_vector() {
+        for ( ; first != last; ++first ) {
+            push_back( *first );
+        }
+    }
+
+    explicit cow_vector( const std::vector<T>& values ) : m_table( std::make_shared<chunk_table>() ) {
+        auto& table = *m_table;
+        table.reserve( ( values.size() + ChunkSize - 1 ) / ChunkSize );
+        for ( size_type i = 0; i < values.size(); i += ChunkSize ) {
+            size_type n = std::min( ChunkSize, values.size() - i );
+            auto c = std::make_shared<chunk>();
+            c->reserve( ChunkSize );
+            c->assign( values.begin() + i, values.begin() + i + n );
+            table.push_back( std::move( c ) );
+        }
+        m_size = values.size();
+    }
+
+    // copies share everything, O(1)
+    cow_vector( const cow_vector& ) = default;
+    cow_vector& operator=( const cow_vector& ) = default;
+    cow_vector( cow_vector&& other ) noexcept
+        : m_table( std::exchange( other.m_table, empty_table() ) ), m_size( std::exchange( other.m_size, 0 ) ) {}
+    cow_vector& operator=( cow_vector&& other ) noexcept {
+        m_table.swap( other.m_table );
+        std::swap( m_size, other.m_size );
+        return *this;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Reads
+    //////////////////////////////////////////////////////////////////////////
+    size_type size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+
+    const T& operator[]( size_type i ) const noexcept {
+        assert( i < m_size );
+        return ( *( *m_table )[i / ChunkSize] )[i % ChunkSize];
+    }
+
+    const_iterator begin() const noexcept { return { this, 0 }; }
+    const_iterator end() const noexcept { return { this, m_size }; }
+
+    // f( const T* first, size_type n ) for each chunk in order, the fast way to scan
+    template< typename F >
+    void for_each_chunk( F&& f ) const {
+        for ( auto& c : *m_table ) {
+            f( static_cast<const T*>( c->data() ), c->size() );
+        }
+    }
+
+    std::vector<T> to_vector() const {
+        std::vector<T> out;
+        out.reserve( m_size );
+        for_each_chunk( [&out]( const T* p, size_type n ) { out.insert( out.end(), p, p + n ); } );
+        return out;
+    }
+
+    // do the two share chunk i, i.e. has neither written to it since they diverged
+    bool shares_chunk_with( const cow_vector& other, size_type chunk_index ) const noexcept {
+        return ( *m_table )[chunk_index] == ( *other.m_table )[chunk_index];
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Writes, each copies at most the table and one chunk
+    //////////////////////////////////////////////////////////////////////////
+    void set( size_type i, const T& value ) { mutable_ref( i ) = value; }
+
+    // the reference is invalidated by the next copy of this vector
+    T& mutable_ref( size_type i ) {
+        assert( i < m_size );
+        return ( *unique_chunk( i / ChunkSize ) )[i % ChunkSize];
+    }
+
+    void push_back( const T& value ) {
+        auto& table = unique_table();
+        if ( m_size % ChunkSize == 0 ) {
+            auto c = std::make_shared<chunk>();
+            c->reserve( ChunkSize );
+            table.push_back( std::move( c ) );
+        }
+        unique_chunk( table.size() - 1 )->push_back( value );
+        ++m_size;
+    }
+
+    void pop_back() {
+        assert( m_size > 0 );
+        auto& table = unique_table();
+        if ( --m_size % ChunkSize == 0 ) {
+            table.pop_back();
+        } else {
+            unique_chunk( table.size() - 1 )->pop_back();
+        }
+    }
+
+    void clear() noexcept {
+        m_table = empty_table();
+        m_size = 0;
+    }
+
+private:
+    // shared by every empty vector so constructing and moving never allocate
+    static std::shared_ptr<chunk_table> empty_table() noexcept {
+        static const std::shared_ptr<chunk_table> empty = std::make_shared<chunk_table>();
+        return empty;
+    }
+
+    chunk_table& unique_table() {
+        if ( !detail::is_unique( m_table ) ) {
+            m_table = std::make_shared<chunk_table>( *m_table );
+        }
+        return *m_table;
+    }
+
+    chunk* unique_chunk( size_type index ) {
+        auto& c = unique_table()[index];
+        if ( !detail::is_unique( c ) ) {
+            auto copy = std::make_shared<chunk>();
+            copy->reserve( ChunkSize );
+            copy->assign( c->begin(), c->end() );
+            c = std::move( copy );
+        }
+        return c.get();
+    }
+
+    std::shared_ptr<chunk_table> m_table;
+    size_type m_size = 0;
+};
+
+} // namespace perf
+
+#endif  // PERF_COW_VECTOR_HPP
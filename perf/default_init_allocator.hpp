@@ -0,0 +1,61 @@
+//  perf/default_init_allocator.hpp  -----------------------------------------//
+
+//  An allocator adaptor that makes std::vector default-initialize instead of
+//  value-initialize.
+//
+//  results.resize( 100'000 ) on a std::vector<int> writes 400KB of zeros
+//  that the caller then overwrites. std::vector value-initializes through
+//  allocator_traits::construct( a, p ), so an allocator whose construct(p)
+//  does `new ( p ) T` (no parentheses) skips the zeroing for trivial types:
+//
+//      perf::default_init_vector<int> results;
+//      results.resize( 100'000 );          // no memset, contents indeterminate
+//      std::iota( results.begin(), results.end(), 0 );
+//
+//  Reading an element before writing it is undefined behavior, exactly like
+//  `int x;`. resize( n, value ) and every other member behave as usual.
+//  perf::vector has the same thing as a member, resize_uninitialized( n ).
+
+#ifndef PERF_DEFAULT_INIT_ALLOCATOR_HPP
+#define PERF_DEFAULT_INIT_ALLOCATOR_HPP
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace perf {
+
+template< typename T, typename Alloc = std::allocator<T> >
+class default_init_allocator : public Alloc {
+    using traits = std::allocator_traits<Alloc>;
+
+public:
+    template< typename U >
+    struct rebind {
+        using other = default_init_allocator<U, typename traits::template rebind_alloc<U>>;
+    };
+
+    using Alloc::Alloc;
+    default_init_allocator() = default;
+    default_init_allocator( const Alloc& a ) noexcept( std::is_nothrow_copy_constructible<Alloc>::value ) : Alloc( a ) {}
+
+    // the one that matters: no parentheses, no zeroing
+    template< typename U >
+    void construct( U* p ) noexcept( std::is_nothrow_default_constructible<U>::value ) {
+        ::new ( static_cast<void*>( p ) ) U;
+    }
+
+    template< typename U, typename... Args >
+    void construct( U* p, Args&&... args ) {
+        traits::construct( static_cast<Alloc&>( *this ), p, std::forward<Args>( args )... );
+    }
+};
+
+template< typename T >
+using default_init_vector = std::vector<T, default_init_allocator<T>>;
+
+} // namespace perf
+
+#endif  // PERF_DEFAULT_INIT_ALLOCATOR_HPP
@@ -0,0 +1,95 @@
+//  perf/delegate.hpp  -------------------------------------------------------//
+
+//  Fixed capacity, never allocating, trivially copyable std::function.
+//
+//      perf::delegate<void( PlayerId )> callback = [&counter]( PlayerId pid ) { counter += pid; };
+//
+//  The callable is stored inline in Size bytes next to one function pointer,
+//  so sizeof( delegate ) == Size + sizeof( void* ) and a call is exactly one
+//  indirect call. A callable that is too big, over-aligned or not trivially
+//  copyable is a compile-time error. The last rule is what keeps the delegate
+//  itself trivially copyable: capture pointers or references, not owners.
+//
+//  Lifetime requirements: like any lambda capture by reference, whatever the
+//  callable refers to must outlive every copy of the delegate.
+
+#ifndef PERF_DELEGATE_HPP
+#define PERF_DELEGATE_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace perf {
+
+template< typename Signature, std::size_t Size = 2 * sizeof( void* ) >
+class delegate;
+
+template< typename R, typename... Args, std::size_t Size >
+class delegate<R( Args... ), Size> {
+public:
+    static constexpr std::size_t capacity = Size;
+
+    //////////////////////////////////////////////////////////////////////////
+    // Construction
+    //////////////////////////////////////////////////////////////////////////
+    // an empty delegate points at a stub that aborts, so calls never test for empty
+    delegate() noexcept = default;
+    delegate( std::nullptr_t ) noexcept {}
+
+    template< typename F, typename = std::enable_if_t<!std::is_same<std::decay_t<F>, delegate>::value &&
+                                                      std::is_invocable_r<R, std::decay_t<F>&, Args...>::value>>
+    delegate( F&& f ) noexcept {
+        using Callable = std::decay_t<F>;
+        static_assert( sizeof( Callable ) <= Size, "callable does not fit, capture less or raise the delegate Size" );
+        static_assert( alignof( Callable ) <= alignof( void* ), "callable is over-aligned for the inline storage" );
+        static_assert( std::is_trivially_copyable<Callable>::value && std::is_trivially_destructible<Callable>::value,
+                       "callable must be trivially copyable, capture pointers or references instead of owners" );
+        new ( static_cast<void*>( m_storage ) ) Callable( std::forward<F>( f ) );
+        m_invoke = &invoke_callable<Callable>;
+    }
+
+    // bind a member function to an object without a wrapping lambda
+    template< auto Method, typename C >
+    static delegate bind( C* object ) noexcept {
+        return delegate( [object]( Args... args ) -> R { return ( object->*Method )( std::forward<Args>( args )... ); } );
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Invocation
+    //////////////////////////////////////////////////////////////////////////
+    R operator()( Args... args ) const {
+        return m_invoke( m_storage, std::forward<Args>( args )... );
+    }
+
+    explicit operator bool() const noexcept { return m_invoke != &invoke_empty; }
+
+    friend bool operator==( const delegate& d, std::nullptr_t ) noexcept { return !d; }
+    friend bool operator!=( const delegate& d, std::nullptr_t ) noexcept { return static_cast<bool>( d ); }
+
+private:
+    using invoker = R ( * )( const void*, Args&&... );
+
+    template< typename Callable >
+    static R invoke_callable( const void* storage, Args&&... args ) {
+        // like std::function, a const delegate may call a mutable lambda
+        auto& f = *static_cast<Callable*>( const_cast<void*>( storage ) );
+        return static_cast<R>( f( std::forward<Args>( args )... ) );
+    }
+
+    static R invoke_empty( const void*, Args&&... ) {
+        assert( !"called an empty perf::delegate" );
+        std::abort();
+    }
+
+    alignas( void* ) unsigned char m_storage[Size] = {};
+    invoker m_invoke = &invoke_empty;
+};
+
+} // namespace perf
+
+#endif  // PERF_DELEGATE_HPP
@@ -0,0 +1,52 @@
+//  perf/fields.hpp  ---------------------------------------------------------//
+
+//  Compile-time member lists, the one description of a struct shared by the
+//  headers that work field by field (serialize.hpp, soa.hpp).
+//
+//  List pointers to the members, in declaration order:
+//
+//      struct Order { std::int64_t id; double price; std::int32_t qty; std::int32_t side; };
+//      template<> struct perf::field_list<Order> : perf::fields<&Order::id, &Order::price,
+//                                                               &Order::qty, &Order::side> {};
+//
+//  A class with private members befriends perf::field_list<T> to list them.
+
+#ifndef PERF_FIELDS_HPP
+#define PERF_FIELDS_HPP
+
+#include <type_traits>
+
+namespace perf {
+
+//////////////////////////////////////////////////////////////////////////
+// Field lists
+//////////////////////////////////////////////////////////////////////////
+template< auto... Members >
+struct fields {};
+
+// specialize for your type, deriving from perf::fields<&T::a, &T::b, ...>
+template< typename T >
+struct field_list;
+
+namespace detail {
+
+template< auto... Members >
+fields<Members...> as_fields( const fields<Members...>& );
+
+template< typename T, typename = void >
+struct has_field_list : std::false_type {};
+
+template< typename T >
+struct has_field_list<T, std::void_t<decltype( as_fields( field_list<T>{} ) )>> : std::true_type {};
+
+template< typename C, typename F >
+F member_type_of( F C::* );
+
+template< auto Member >
+using member_t = decltype( member_type_of( Member ) );
+
+} // namespace detail
+
+} // namespace perf
+
+#endif  // PERF_FIELDS_HPP
@@ -0,0 +1,346 @@
+//  perf/find.hpp  -----------------------------------------------------------//
+
+//  find_equal / find_not_equal and the any_equal / none_equal / all_equal
+//  overload set from parameter_modern.cpp, vectorized for contiguous ranges.
+//
+//  For pointers and contiguous ranges of arithmetic types the AVX2 kernel
+//  compares 32 bytes per instruction, four registers per iteration, and
+//  checks the combined movemask once per 128 bytes so a hit still exits
+//  early. Every other iterator goes through std::find / std::find_if exactly
+//  as before.
+//
+//  The vectorized path is taken only when comparing against the needle
+//  converted to the element type gives the same answer as x == value: the
+//  same type, or an integer needle representable in an integer element type.
+//  Floating point follows ==: NaN is never equal, -0.0 equals 0.0.
+//
+//  The perf::parallel overloads split large random access ranges into blocks
+//  handed out in order across a thread_pool. The first hit publishes its index
+//  and every block starting past it is skipped, so an early hit returns about
+//  as fast as the sequential search. Ranges under a few blocks stay sequential.
+
+#ifndef PERF_FIND_HPP
+#define PERF_FIND_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+namespace perf {
+
+namespace detail {
+
+//////////////////////////////////////////////////////////////////////////
+// Eligibility
+//////////////////////////////////////////////////////////////////////////
+template< typename T >
+constexpr bool simd_searchable = std::is_arithmetic<T>::value && !std::is_same<T, bool>::value &&
+                                 ( sizeof( T ) == 1 || sizeof( T ) == 2 || sizeof( T ) == 4 || sizeof( T ) == 8 );
+
+// converts value to T when x == value and x == needle agree for every x of type T
+template< typename T, typename Value >
+bool exact_needle( const Value& value, T& needle ) noexcept {
+    if constexpr ( std::is_same<T, Value>::value ) {
+        needle = value;
+        return true;
+    } else if constexpr ( std::is_integral<T>::value && std::is_integral<Value>::value && !std::is_same<Value, bool>::value ) {
+        needle = static_cast<T>( value );
+        // representable and same sign
+        return static_cast<Value>( needle ) == value && ( needle < T{} ) == ( value < Value{} );
+    } else {
+        (void)value;
+        (void)needle;
+        return false;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Kernels
+//////////////////////////////////////////////////////////////////////////
+template< typename T >
+std::size_t find_equal_scalar( const T* p, std::size_t n, T needle ) noexcept {
+    return static_cast<std::size_t>( std::find( p, p + n, needle ) - p );
+}
+
+template< typename T >
+std::size_t find_not_equal_scalar( const T* p, std::size_t n, T needle ) noexcept {
+    return static_cast<std::size_t>( std::find_if( p, p + n, [needle]( T x ) { return !( x == needle ); } ) - p );
+}
+
+#if PERF_AVX2
+template< typename T >
+inline __m256i broadcast( T v ) noexcept {
+    if constexpr ( std::is_same<T, float>::value ) {
+        return _mm256_castps_si256( _mm256_set1_ps( v ) );
+    } else if constexpr ( std::is_same<T, double>::value ) {
+        return _mm256_castpd_si256( _mm256_set1_pd( v ) );
+    } else if constexpr ( sizeof( T ) == 1 ) {
+        return _mm256_set1_epi8( static_cast<char>( v ) );
+    } else if constexpr ( sizeof( T ) == 2 ) {
+        return _mm256_set1_epi16( static_cast<short>( v ) );
+    } else if constexpr ( sizeof( T ) == 4 ) {
+        return _mm256_set1_epi32( static_cast<int>( v ) );
+    } else {
+        return _mm256_set1_epi64x( static_cast<long long>( v ) );
+    }
+}
+
+// all ones in the lanes of a that equal b
+template< typename T >
+inline __m256i equal_lanes( __m256i a, __m256i b ) noexcept {
+    if constexpr ( std::is_same<T, float>::value ) {
+        return _mm256_castps_si256( _mm256_cmp_ps( _mm256_castsi256_ps( a ), _mm256_castsi256_ps( b ), _CMP_EQ_OQ ) );
+    } else if constexpr ( std::is_same<T, double>::value ) {
+        return _mm256_castpd_si256( _mm256_cmp_pd( _mm256_castsi256_pd( a ), _mm256_castsi256_pd( b ), _CMP_EQ_OQ ) );
+    } else if constexpr ( sizeof( T ) == 1 ) {
+        return _mm256_cmpeq_epi8( a, b );
+    } else if constexpr ( sizeof( T ) == 2 ) {
+        return _mm256_cmpeq_epi16( a, b );
+    } else if constexpr ( sizeof( T ) == 4 ) {
+        return _mm256_cmpeq_epi32( a, b );
+    } else {
+        return _mm256_cmpeq_epi64( a, b );
+    }
+}
+
+// index of the first element where equal(x, needle) == Match, or n
+template< bool Match, typename T >
+std::size_t find_avx2( const T* p, std::size_t n, T needle ) noexcept {
+    constexpr std::size_t lanes = 32 / sizeof( T );
+    const __m256i v = broadcast( needle );
+    auto load = [p]( std::size_t i ) { return _mm256_loadu_si256( reinterpret_cast<const __m256i*>( p + i ) ); };
+    // bit per byte, set where the lane is a hit
+    auto hits = []( __m256i eq ) {
+        auto mask = static_cast<std::uint32_t>( _mm256_movemask_epi8( eq ) );
+        return Match ? mask : ~mask;
+    };
+
+    std::size_t i = 0;
+    for ( ; i + 4 * lanes <= n; i += 4 * lanes ) {
+        __m256i e0 = equal_lanes<T>( load( i ), v );
+        __m256i e1 = equal_lanes<T>( load( i + lanes ), v );
+        __m256i e2 = equal_lanes<T>( load( i + 2 * lanes ), v );
+        __m256i e3 = equal_lanes<T>( load( i + 3 * lanes ), v );
+        // any lane equal: OR the masks; any lane not equal: AND them
+        __m256i combined = Match ? _mm256_or_si256( _mm256_or_si256( e0, e1 ), _mm256_or_si256( e2, e3 ) )
+                                 : _mm256_and_si256( _mm256_and_si256( e0, e1 ), _mm256_and_si256( e2, e3 ) );
+        if ( hits( combined ) != 0 ) {
+            const __m256i e[4] = { e0, e1, e2, e3 };
+            for ( std::size_t k = 0;; ++k ) {
+                if ( std::uint32_t mask = hits( e[k] ) ) {
+                    return i + k * lanes + count_trailing_zeros( mask ) / sizeof( T );
+                }
+            }
+        }
+    }
+    for ( ; i + lanes <= n; i += lanes ) {
+        if ( std::uint32_t mask = hits( equal_lanes<T>( load( i ), v ) ) ) {
+            return i + count_trailing_zeros( mask ) / sizeof( T );
+        }
+    }
+    return i + ( Match ? find_equal_scalar( p + i, n - i, needle ) : find_not_equal_scalar( p + i, n - i, needle ) );
+}
+#endif
+
+template< bool Match, typename T >
+std::size_t find_contiguous( const T* p, std::size_t n, T needle ) noexcept {
+#if PERF_AVX2
+    return find_avx2<Match>( p, n, needle );
+#else
+    return Match ? find_equal_scalar( p, n, needle ) : find_not_equal_scalar( p, n, needle );
+#endif
+}
+
+template< typename It >
+constexpr bool is_pointer_to_searchable = std::is_pointer<It>::value &&
+                                          simd_searchable<std::remove_cv_t<std::remove_pointer_t<It>>>;
+
+} // namespace detail
+
+//////////////////////////////////////////////////////////////////////////
+// find_equal / find_not_equal
+//////////////////////////////////////////////////////////////////////////
+// std::find( first, last, value )
+template< typename InputIt, typename Value >
+InputIt find_equal( InputIt first, InputIt last, const Value& value ) {
+    if constexpr ( detail::is_pointer_to_searchable<InputIt> ) {
+        using T = std::remove_cv_t<std::remove_pointer_t<InputIt>>;
+        T needle;
+        if ( detail::exact_needle( value, needle ) ) {
+            return first + detail::find_contiguous<true>( first, static_cast<std::size_t>( last - first ), needle );
+        }
+    }
+    return std::find( first, last, value );
+}
+
+// the first element that is not equal to value
+template< typename InputIt, typename Value >
+InputIt find_not_equal( InputIt first, InputIt last, const Value& value ) {
+    if constexpr ( detail::is_pointer_to_searchable<InputIt> ) {
+        using T = std::remove_cv_t<std::remove_pointer_t<InputIt>>;
+        T needle;
+        if ( detail::exact_needle( value, needle ) ) {
+            return first + detail::find_contiguous<false>( first, static_cast<std::size_t>( last - first ), needle );
+        }
+    }
+    return std::find_if( first, last, [&value]( auto&& x ) { return !( x == value ); } );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// any_equal / none_equal / all_equal
+//////////////////////////////////////////////////////////////////////////
+template< typename InputIt, typename Value >
+bool any_equal( InputIt first, InputIt last, const Value& value ) {
+    return find_equal( first, last, value ) != last;
+}
+
+template< typename InputIt, typename Value >
+bool none_equal( InputIt first, InputIt last, const Value& value ) {
+    return find_equal( first, last, value ) == last;
+}
+
+template< typename InputIt, typename Value >
+bool all_equal( InputIt first, InputIt last, const Value& value ) {
+    return find_not_equal( first, last, value ) == last;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Parallel overloads
+//////////////////////////////////////////////////////////////////////////
+namespace detail {
+
+// elements per block: big enough to amortize the handout, small enough to stop soon after a hit
+constexpr std::size_t search_block = std::size_t{ 1 } << 16;
+
+template< typename It >
+constexpr bool is_random_access =
+    std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<It>::iterator_category>::value;
+
+// index of the first element where find( block ) reports a hit, or n
+template< typename Find >
+std::size_t parallel_find( thread_pool& pool, std::size_t n, Find find ) {
+    if ( n < 4 * search_block || pool.concurrency() == 1 ) {
+        return find( 0, n );
+    }
+    std::atomic<std::size_t> found{ n };
+    std::size_t blocks = ( n + search_block - 1 ) / search_block;
+    pool.run( blocks, [&]( std::size_t block ) {
+        std::size_t begin = block * search_block;
+        // a hit before this block already decides the answer
+        if ( begin >= found.load( std::memory_order_relaxed ) ) {
+            return;
+        }
+        std::size_t end = std::min( n, begin + search_block );
+        std::size_t hit = find( begin, end );
+        if ( hit == end ) {
+            return;
+        }
+        // keep the smallest, a later block can finish first
+        std::size_t current = found.load( std::memory_order_relaxed );
+        while ( hit < current && !found.compare_exchange_weak( current, hit, std::memory_order_relaxed ) ) {
+        }
+    } );
+    // run returning orders every store before this load
+    return found.load( std::memory_order_relaxed );
+}
+
+} // namespace detail
+
+template< typename RandomIt, typename Value >
+RandomIt find_equal( parallel_t policy, RandomIt first, RandomIt last, const Value& value ) {
+    static_assert( detail::is_random_access<RandomIt>, "perf::parallel find needs random access iterators" );
+    auto n = static_cast<std::size_t>( last - first );
+    return first + detail::parallel_find( policy.pool(), n, [first, &value]( std::size_t b, std::size_t e ) {
+               return static_cast<std::size_t>( find_equal( first + b, first + e, value ) - first );
+           } );
+}
+
+template< typename RandomIt, typename Value >
+RandomIt find_not_equal( parallel_t policy, RandomIt first, RandomIt last, const Value& value ) {
+    static_assert( detail::is_random_access<RandomIt>, "perf::parallel find needs random access iterators" );
+    auto n = static_cast<std::size_t>( last - first );
+    return first + detail::parallel_find( policy.pool(), n, [first, &value]( std::size_t b, std::size_t e ) {
+               return static_cast<std::size_t>( find_not_equal( first + b, first + e, value ) - first );
+           } );
+}
+
+template< typename RandomIt, typename Value >
+bool any_equal( parallel_t policy, RandomIt first, RandomIt last, const Value& value ) {
+    return find_equal( policy, first, last, value ) != last;
+}
+
+template< typename RandomIt, typename Value >
+bool none_equal( parallel_t policy, RandomIt first, RandomIt last, const Value& value ) {
+    return find_equal( policy, first, last, value ) == last;
+}
+
+template< typename RandomIt, typename Value >
+bool all_equal( parallel_t policy, RandomIt first, RandomIt last, const Value& value ) {
+    return find_not_equal( policy, first, last, value ) == last;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Range overloads
+//////////////////////////////////////////////////////////////////////////
+namespace detail {
+
+template< typename Range, typename = void >
+struct is_contiguous_range : std::false_type {};
+
+template< typename Range >
+struct is_contiguous_range<Range, std::void_t<decltype( std::data( std::declval<Range&>() ) ),
+                                              decltype( std::size( std::declval<Range&>() ) )>> : std::true_type {};
+
+// contiguous ranges become pointers so they reach the kernels, anything else keeps its iterators
+template< typename Range, typename F >
+decltype( auto ) with_bounds( Range&& r, F&& f ) {
+    if constexpr ( is_contiguous_range<Range>::value ) {
+        auto p = std::data( r );
+        return f( p, p + std::size( r ) );
+    } else {
+        using std::begin;
+        using std::end;
+        return f( begin( r ), end( r ) );
+    }
+}
+
+} // namespace detail
+
+template< typename Range, typename Value >
+bool any_equal( Range&& r, const Value& value ) {
+    return detail::with_bounds( r, [&value]( auto first, auto last ) { return any_equal( first, last, value ); } );
+}
+
+template< typename Range, typename Value >
+bool none_equal( Range&& r, const Value& value ) {
+    return detail::with_bounds( r, [&value]( auto first, auto last ) { return none_equal( first, last, value ); } );
+}
+
+template< typename Range, typename Value >
+bool all_equal( Range&& r, const Value& value ) {
+    return detail::with_bounds( r, [&value]( auto first, auto last ) { return all_equal( first, last, value ); } );
+}
+
+template< typename Range, typename Value >
+bool any_equal( parallel_t policy, Range&& r, const Value& value ) {
+    return detail::with_bounds( r, [&]( auto first, auto last ) { return any_equal( policy, first, last, value ); } );
+}
+
+template< typename Range, typename Value >
+bool none_equal( parallel_t policy, Range&& r, const Value& value ) {
+    return detail::with_bounds( r, [&]( auto first, auto last ) { return none_equal( policy, first, last, value ); } );
+}
+
+template< typename Range, typename Value >
+bool all_equal( parallel_t policy, Range&& r, const Value& value ) {
+    return detail::with_bounds( r, [&]( auto first, auto last ) { return all_equal( policy, first, last, value ); } );
+}
+
+} // namespace perf
+
+#endif  // PERF_FIND_HPP
@@ -0,0 +1,304 @@
+//  perf/flat_set.hpp  -------------------------------------------------------//
+
+//  Sorted contiguous containers for integer keys such as PlayerId.
+//
+//  flat_set<Key>        sorted std::vector<Key>, branchless / SIMD lower_bound
+//  flat_map<Key, T>     keys and values in separate vectors, lookups only touch keys
+//  eytzinger_set<Key>   read-only set in BFS (Eytzinger) order, for sets too big for L2
+//
+//  Single inserts and erases are O(n) like any sorted vector. Build or update
+//  large sets with the range insert, which sorts the new keys and merges once.
+
+#ifndef PERF_FLAT_SET_HPP
+#define PERF_FLAT_SET_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "simd.hpp"
+
+namespace perf {
+
+//////////////////////////////////////////////////////////////////////////
+// branchless_lower_bound
+//////////////////////////////////////////////////////////////////////////
+// same result as std::lower_bound, but the loop trip count depends only on n
+// and the comparison turns into a conditional move instead of a mispredicted branch
+template< typename Key >
+const Key* branchless_lower_bound( const Key* first, const Key* last, Key key ) noexcept {
+    static_assert( std::is_integral<Key>::value, "integer keys only" );
+    auto n = static_cast<std::size_t>( last - first );
+    if ( n == 0 ) {
+        return first;
+    }
+    const Key* base = first;
+#if PERF_AVX2
+    if constexpr ( std::is_same<Key, std::int32_t>::value ) {
+        // bisect down to one 16 element window, then count the keys below `key` in it
+        while ( n > 16 ) {
+            std::size_t half = n / 2;
+            base = base[half] < key ? base + half : base;
+            n -= half;
+        }
+        if ( last - base >= 16 ) {
+            const __m256i needle = _mm256_set1_epi32( key );
+            __m256i lo = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( base ) );
+            __m256i hi = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( base + 8 ) );
+            auto below_lo = static_cast<std::uint32_t>( _mm256_movemask_ps( _mm256_castsi256_ps( _mm256_cmpgt_epi32( needle, lo ) ) ) );
+            auto below_hi = static_cast<std::uint32_t>( _mm256_movemask_ps( _mm256_castsi256_ps( _mm256_cmpgt_epi32( needle, hi ) ) ) );
+            std::uint32_t window = ( below_lo | below_hi << 8 ) & ( ( std::uint32_t{ 1 } << n ) - 1 );
+            return base + popcount( window );
+        }
+    }
+#endif
+    while ( n > 1 ) {
+        std::size_t half = n / 2;
+        base = base[half] < key ? base + half : base;
+        n -= half;
+    }
+    return base + ( *base < key );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// flat_set
+//////////////////////////////////////////////////////////////////////////
+template< typename Key >
+class flat_set {
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using size_type = std::size_t;
+    using const_iterator = typename std::vector<Key>::const_iterator;
+    using iterator = const_iterator;
+
+    flat_set() = default;
+
+    template< typename InputIt >
+    flat_set( InputIt first, InputIt last ) { insert( first, last ); }
+    flat_set( std::initializer_list<Key> keys ) { insert( keys.begin(), keys.end() ); }
+
+    size_type size() const noexcept { return m_keys.size(); }
+    bool empty() const noexcept { return m_keys.empty(); }
+    const Key* data() const noexcept { return m_keys.data(); }
+    const_iterator begin() const noexcept { return m_keys.begin(); }
+    const_iterator end() const noexcept { return m_keys.end(); }
+    void reserve( size_type n ) { m_keys.reserve( n ); }
+    void clear() noexcept { m_keys.clear(); }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Lookup
+    //////////////////////////////////////////////////////////////////////////
+    const_iterator lower_bound( Key key ) const noexcept {
+        const Key* p = branchless_lower_bound( m_keys.data(), m_keys.data() + m_keys.size(), key );
+        return begin() + ( p - m_keys.data() );
+    }
+
+    bool contains( Key key ) const noexcept {
+        auto it = lower_bound( key );
+        return it != end() && *it == key;
+    }
+
+    const_iterator find( Key key ) const noexcept {
+        auto it = lower_bound( key );
+        return it != end() && *it == key ? it : end();
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Modifiers
+    //////////////////////////////////////////////////////////////////////////
+    std::pair<const_iterator, bool> insert( Key key ) {
+        auto i = lower_bound( key ) - begin();
+        if ( static_cast<size_type>( i ) != size() && m_keys[i] == key ) {
+            return { begin() + i, false };
+        }
+        m_keys.insert( m_keys.begin() + i, key );
+        return { begin() + i, true };
+    }
+
+    // O(n + m log m): sort the m new keys and merge them in one pass
+    template< typename InputIt >
+    void insert( InputIt first, InputIt last ) {
+        auto middle = static_cast<std::ptrdiff_t>( m_keys.size() );
+        m_keys.insert( m_keys.end(), first, last );
+        std::sort( m_keys.begin() + middle, m_keys.end() );
+        std::inplace_merge( m_keys.begin(), m_keys.begin() + middle, m_keys.end() );
+        m_keys.erase( std::unique( m_keys.begin(), m_keys.end() ), m_keys.end() );
+    }
+
+    size_type erase( Key key ) {
+        auto it = find( key );
+        if ( it == end() ) {
+            return 0;
+        }
+        m_keys.erase( it );
+        return 1;
+    }
+
+    friend bool operator==( const flat_set& lhs, const flat_set& rhs ) { return lhs.m_keys == rhs.m_keys; }
+    friend bool operator!=( const flat_set& lhs, const flat_set& rhs ) { return !( lhs == rhs ); }
+
+private:
+    std::vector<Key> m_keys;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// flat_map
+//////////////////////////////////////////////////////////////////////////
+template< typename Key, typename T >
+class flat_map {
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using size_type = std::size_t;
+
+    size_type size() const noexcept { return m_keys.size(); }
+    bool empty() const noexcept { return m_keys.empty(); }
+    const std::vector<Key>& keys() const noexcept { return m_keys; }
+    const std::vector<T>& values() const noexcept { return m_values; }
+    void clear() noexcept {
+        m_keys.clear();
+        m_values.clear();
+    }
+
+    bool contains( Key key ) const noexcept { return index_of( key ) != npos; }
+
+    // nullptr when the key is missing
+    T* find( Key key ) noexcept {
+        auto i = index_of( key );
+        return i == npos ? nullptr : &m_values[i];
+    }
+    const T* find( Key key ) const noexcept { return const_cast<flat_map*>( this )->find( key ); }
+
+    T& operator[]( Key key ) { return *try_emplace( key ).first; }
+
+    template< typename... Args >
+    std::pair<T*, bool> try_emplace( Key key, Args&&... args ) {
+        auto i = lower_index( key );
+        if ( i != size() && m_keys[i] == key ) {
+            return { &m_values[i], false };
+        }
+        m_values.emplace( m_values.begin() + i, std::forward<Args>( args )... );
+        m_keys.insert( m_keys.begin() + i, key );
+        return { &m_values[i], true };
+    }
+
+    template< typename V >
+    void insert_or_assign( Key key, V&& value ) {
+        auto r = try_emplace( key, std::forward<V>( value ) );
+        if ( !r.second ) {
+            *r.first = std::forward<V>( value );
+        }
+    }
+
+    // bulk insert of (key, value) pairs, existing keys and earlier duplicates win like std::map::insert
+    template< typename InputIt >
+    void insert( InputIt first, InputIt last ) {
+        std::vector<std::pair<Key, T>> fresh( first, last );
+        std::stable_sort( fresh.begin(), fresh.end(), []( const auto& a, const auto& b ) { return a.first < b.first; } );
+        fresh.erase( std::unique( fresh.begin(), fresh.end(), []( const auto& a, const auto& b ) { return a.first == b.first; } ),
+                     fresh.end() );
+
+        std::vector<Key> keys;
+        std::vector<T> values;
+        keys.reserve( m_keys.size() + fresh.size() );
+        values.reserve( m_keys.size() + fresh.size() );
+        std::size_t i = 0;
+        auto j = fresh.begin();
+        while ( i < m_keys.size() || j != fresh.end() ) {
+            bool take_old = j == fresh.end() || ( i < m_keys.size() && m_keys[i] <= j->first );
+            if ( take_old ) {
+                if ( j != fresh.end() && m_keys[i] == j->first ) {
+                    ++j;
+                }
+                keys.push_back( m_keys[i] );
+                values.push_back( std::move( m_values[i] ) );
+                ++i;
+            } else {
+                keys.push_back( j->first );
+                values.push_back( std::move( j->second ) );
+                ++j;
+            }
+        }
+        m_keys.swap( keys );
+        m_values.swap( values );
+    }
+
+    size_type erase( Key key ) {
+        auto i = index_of( key );
+        if ( i == npos ) {
+            return 0;
+        }
+        m_keys.erase( m_keys.begin() + i );
+        m_values.erase( m_values.begin() + i );
+        return 1;
+    }
+
+private:
+    static constexpr size_type npos = ~size_type{ 0 };
+
+    size_type lower_index( Key key ) const noexcept {
+        return static_cast<size_type>( branchless_lower_bound( m_keys.data(), m_keys.data() + m_keys.size(), key ) - m_keys.data() );
+    }
+    size_type index_of( Key key ) const noexcept {
+        auto i = lower_index( key );
+        return i != size() && m_keys[i] == key ? i : npos;
+    }
+
+    std::vector<Key> m_keys;
+    std::vector<T> m_values;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// eytzinger_set
+//////////////////////////////////////////////////////////////////////////
+// the implicit binary search tree stored breadth first: the children of node k are 2k and 2k+1
+// the first levels of every search share cache lines, and the next levels can be prefetched
+// read-only, rebuild it from a flat_set after a batch of updates
+template< typename Key >
+class eytzinger_set {
+public:
+    eytzinger_set() = default;
+
+    explicit eytzinger_set( const flat_set<Key>& sorted ) : m_tree( sorted.size() + 1 ) {
+        std::size_t next = 0;
+        build( sorted.data(), next, 1 );
+    }
+
+    std::size_t size() const noexcept { return m_tree.empty() ? 0 : m_tree.size() - 1; }
+
+    bool contains( Key key ) const noexcept {
+        const std::size_t n = size();
+        const Key* tree = m_tree.data();
+        std::size_t k = 1;
+        while ( k <= n ) {
+            // four levels down is 16 keys ahead, one cache line for 32-bit keys
+            prefetch( tree + std::min( k * 16, n ) );
+            k = 2 * k + ( tree[k] < key );
+        }
+        // undo the trailing right turns plus one left turn to find the lower bound
+        k >>= count_trailing_zeros( static_cast<std::uint64_t>( ~k ) ) + 1;
+        return k != 0 && tree[k] == key;
+    }
+
+private:
+    // in-order walk of the implicit tree assigns the sorted keys
+    void build( const Key* sorted, std::size_t& next, std::size_t k ) {
+        if ( k < m_tree.size() ) {
+            build( sorted, next, 2 * k );
+            m_tree[k] = sorted[next++];
+            build( sorted, next, 2 * k + 1 );
+        }
+    }
+
+    std::vector<Key> m_tree;
+};
+
+} // namespace perf
+
+#endif  // PERF_FLAT_SET_HPP
@@ -0,0 +1,671 @@
+//  perf/hash_set.hpp  -------------------------------------------------------//
+
+//  Open addressing hash containers for regular types such as PlayerId or
+//  RegularWidget, in the style of Abseil's SwissTable.
+//
+//  hash_set<Key, Hash, Eq>       drop-in for the common std::unordered_set operations
+//  hash_map<Key, T, Hash, Eq>    the same for std::unordered_map
+//
+//  std::unordered_set allocates a node per element and chains the nodes of
+//  a bucket, so a lookup is a pointer chase and a miss walks the whole chain.
+//  Here the elements live in one array next to a byte of metadata per slot:
+//  empty, deleted, or 7 bits of the element's hash. A lookup loads the 16
+//  control bytes of a group, compares all of them with the hash bits in one
+//  SSE2 instruction and only calls Eq on the (usually single) candidate. A
+//  group with an empty slot ends the probe, so most misses touch no element.
+//
+//  Equality is Eq, std::equal_to<Key> (operator==) by default. The hash result
+//  is mixed before use, so weak hashes such as std::hash<int> (the identity)
+//  work. When both Hash and Eq declare is_transparent, find, contains, count
+//  and erase accept any type they can hash and compare, e.g. a
+//  std::string_view for a set of std::string.
+//
+//  Rehashing moves the elements, so inserts invalidate iterators and
+//  references. The maximum load factor is 7/8.
+
+#ifndef PERF_HASH_SET_HPP
+#define PERF_HASH_SET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "simd.hpp"
+
+namespace perf {
+
+namespace detail {
+
+//////////////////////////////////////////////////////////////////////////
+// Control bytes
+//////////////////////////////////////////////////////////////////////////
+// full slots hold the low 7 hash bits, so the sign bit marks empty and deleted
+using ctrl_t = std::int8_t;
+constexpr ctrl_t ctrl_empty = -128;
+constexpr ctrl_t ctrl_deleted = -2;
+constexpr std::size_t group_width = 16;
+
+// a bit per slot of an aligned group of 16
+class ctrl_group {
+public:
+    explicit ctrl_group( const ctrl_t* p ) noexcept {
+#if PERF_SSE2
+        m_ctrl = _mm_load_si128( reinterpret_cast<const __m128i*>( p ) );
+#else
+        std::memcpy( m_ctrl, p, group_width );
+#endif
+    }
+
+    std::uint32_t match( ctrl_t h2 ) const noexcept {
+#if PERF_SSE2
+        return static_cast<std::uint32_t>( _mm_movemask_epi8( _mm_cmpeq_epi8( m_ctrl, _mm_set1_epi8( h2 ) ) ) );
+#else
+        return mask( [h2]( ctrl_t c ) { return c == h2; } );
+#endif
+    }
+
+    std::uint32_t match_empty() const noexcept {
+#if PERF_SSE2
+        return static_cast<std::uint32_t>( _mm_movemask_epi8( _mm_cmpeq_epi8( m_ctrl, _mm_set1_epi8( ctrl_empty ) ) ) );
+#else
+        return mask( []( ctrl_t c ) { return c == ctrl_empty; } );
+#endif
+    }
+
+    // empty or deleted
+    std::uint32_t match_free() const noexcept {
+#if PERF_SSE2
+        return static_cast<std::uint32_t>( _mm_movemask_epi8( m_ctrl ) );
+#else
+        return mask( []( ctrl_t c ) { return c < 0; } );
+#endif
+    }
+
+private:
+#if PERF_SSE2
+    __m128i m_ctrl;
+#else
+    template< typename Pred >
+    std::uint32_t mask( Pred pred ) const noexcept {
+        std::uint32_t m = 0;
+        for ( std::size_t i = 0; i < group_width; ++i ) {
+            m |= std::uint32_t( pred( m_ctrl[i] ) ) << i;
+        }
+        return m;
+    }
+
+    ctrl_t m_ctrl[group_width];
+#endif
+};
+
+// the table of a default constructed container: one group, all empty, so lookups need no special case
+alignas( group_width ) inline constexpr ctrl_t empty_group[group_width] = {
+    ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty,
+    ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty };
+
+// spreads every input bit over the result, std::hash of an integer is often the integer itself
+inline std::uint64_t mix_hash( std::uint64_t h ) noexcept {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t m = static_cast<__uint128_t>( h ) * 0x9E3779B97F4A7C15ull;
+    return static_cast<std::uint64_t>( m ) ^ static_cast<std::uint64_t>( m >> 64 );
+#else
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    return h ^ ( h >> 33 );
+#endif
+}
+
+template< typename T, typename = void >
+struct is_transparent : std::false_type {};
+
+template< typename T >
+struct is_transparent<T, std::void_t<typename T::is_transparent>> : std::true_type {};
+
+//////////////////////////////////////////////////////////////////////////
+// swiss_table
+//////////////////////////////////////////////////////////////////////////
+template< typename Key >
+struct set_policy {
+    using slot_type = Key;
+    using value_type = const Key;
+    static const Key& key( const slot_type& slot ) noexcept { return slot; }
+};
+
+template< typename Key, typename T >
+struct map_policy {
+    using slot_type = std::pair<const Key, T>;
+    using value_type = slot_type;
+    static const Key& key( const slot_type& slot ) noexcept { return slot.first; }
+};
+
+// the table both containers share, Policy says what a slot holds and where its key is
+template< typename Key, typename Policy, typename Hash, typename Eq >
+class swiss_table {
+    using slot_type = typename Policy::slot_type;
+    static constexpr std::size_t npos = ~std::size_t{ 0 };
+
+public:
+    using key_type = Key;
+    using value_type = std::remove_const_t<typename Policy::value_type>;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using key_equal = Eq;
+
+    //////////////////////////////////////////////////////////////////////////
+    // Iterators
+    //////////////////////////////////////////////////////////////////////////
+    template< bool Const >
+    class basic_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = swiss_table::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const value_type&, typename Policy::value_type&>;
+        using pointer = std::remove_reference_t<reference>*;
+
+        basic_iterator() = default;
+        // iterator converts to const_iterator
+        template< bool C = Const, typename = std::enable_if_t<C> >
+        basic_iterator( const basic_iterator<false>& other ) noexcept
+            : m_ctrl( other.m_ctrl ), m_slot( other.m_slot ), m_end( other.m_end ) {}
+
+        reference operator*() const noexcept { return *m_slot; }
+        pointer operator->() const noexcept { return m_slot; }
+        basic_iterator& operator++() noexcept {
+            ++m_ctrl;
+            ++m_slot;
+            skip_free();
+            return *this;
+        }
+        basic_iterator operator++( int ) noexcept {
+            basic_iterator old = *this;
+            ++*this;
+            return old;
+        }
+        friend bool operator==( const basic_iterator& a, const basic_iterator& b ) noexcept { return a.m_ctrl == b.m_ctrl; }
+        friend bool operator!=( const basic_iterator& a, const basic_iterator& b ) noexcept { return a.m_ctrl != b.m_ctrl; }
+
+    private:
+        friend class swiss_table;
+        template< bool >
+        friend class basic_iterator;
+
+        basic_iterator( const ctrl_t* ctrl, slot_type* slot, const ctrl_t* end ) noexcept
+            : m_ctrl( ctrl ), m_slot( slot ), m_end( end ) {}
+
+        void skip_free() noexcept {
+            while ( m_ctrl != m_end && *m_ctrl < 0 ) {
+                ++m_ctrl;
+                ++m_slot;
+            }
+        }
+
+        const ctrl_t* m_ctrl = nullptr;
+        slot_type* m_slot = nullptr;
+        const ctrl_t* m_end = nullptr;
+    };
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+private:
+    // heterogeneous overloads exist when both Hash and Eq opt in
+    // an iterator is never a key, so erase( it ) still picks erase( const_iterator )
+    template< typename K, typename H >
+    using if_transparent = std::enable_if_t<is_transparent<H>::value && is_transparent<Eq>::value &&
+                                                !std::is_convertible<const K&, iterator>::value &&
+                                                !std::is_convertible<const K&, const_iterator>::value,
+                                            int>;
+
+public:
+
+    //////////////////////////////////////////////////////////////////////////
+    // Construction
+    //////////////////////////////////////////////////////////////////////////
+    swiss_table() = default;
+    explicit swiss_table( size_type capacity, const Hash& hash = Hash(), const Eq& eq = Eq() )
+        : m_hash( hash ), m_eq( eq ) {
+        reserve( capacity );
+    }
+    swiss_table( const swiss_table& other ) : m_hash( other.m_hash ), m_eq( other.m_eq ) {
+        reserve( other.size() );
+        for ( const auto& slot : other ) {
+            insert_unique( hash_of( Policy::key( slot ) ), slot );
+        }
+    }
+    swiss_table( swiss_table&& other ) noexcept
+        : m_hash( std::move( other.m_hash ) ), m_eq( std::move( other.m_eq ) ) {
+        steal( other );
+    }
+    swiss_table& operator=( const swiss_table& other ) {
+        if ( this != &other ) {
+            swiss_table copy( other );
+            *this = std::move( copy );
+        }
+        return *this;
+    }
+    swiss_table& operator=( swiss_table&& other ) noexcept {
+        if ( this != &other ) {
+            release();
+            m_hash = std::move( other.m_hash );
+            m_eq = std::move( other.m_eq );
+            steal( other );
+        }
+        return *this;
+    }
+    ~swiss_table() { release(); }
+
+    size_type size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+    size_type capacity() const noexcept { return m_capacity; }
+    hasher hash_function() const { return m_hash; }
+    key_equal key_eq() const { return m_eq; }
+
+    iterator begin() noexcept { return make_iterator<false>( 0, true ); }
+    iterator end() noexcept { return make_iterator<false>( m_capacity, false ); }
+    const_iterator begin() const noexcept { return make_iterator<true>( 0, true ); }
+    const_iterator end() const noexcept { return make_iterator<true>( m_capacity, false ); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    // room for n elements without a rehash
+    void reserve( size_type n ) {
+        if ( n == 0 ) {
+            return;
+        }
+        size_type capacity = group_width;
+        while ( capacity - capacity / 8 < n ) {
+            capacity *= 2;
+        }
+        if ( capacity > m_capacity ) {
+            rehash( capacity );
+        }
+    }
+
+    void clear() noexcept {
+        destroy_all();
+        if ( m_capacity != 0 ) {
+            std::memset( m_ctrl, static_cast<unsigned char>( ctrl_empty ), m_capacity );
+        }
+        m_size = 0;
+        m_growth_left = m_capacity - m_capacity / 8;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Lookup
+    //////////////////////////////////////////////////////////////////////////
+    iterator find( const key_type& key ) { return iterator_at<false>( find_index( key ) ); }
+    const_iterator find( const key_type& key ) const { return iterator_at<true>( find_index( key ) ); }
+    bool contains( const key_type& key ) const { return find_index( key ) != npos; }
+    size_type count( const key_type& key ) const { return contains( key ) ? 1 : 0; }
+
+    template< typename K, typename H = Hash, if_transparent<K, H> = 0 >
+    iterator find( const K& key ) { return iterator_at<false>( find_index( key ) ); }
+    template< typename K, typename H = Hash, if_transparent<K, H> = 0 >
+    const_iterator find( const K& key ) const { return iterator_at<true>( find_index( key ) ); }
+    template< typename K, typename H = Hash, if_transparent<K, H> = 0 >
+    bool contains( const K& key ) const { return find_index( key ) != npos; }
+    template< typename K, typename H = Hash, if_transparent<K, H> = 0 >
+    size_type count( const K& key ) const { return contains( key ) ? 1 : 0; }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Modifiers
+    //////////////////////////////////////////////////////////////////////////
+    size_type erase( const key_type& key ) { return erase_index( find_index( key ) ); }
+    template< typename K, typename H = Hash, if_transparent<K, H> = 0 >
+    size_type erase( const K& key ) { return erase_index( find_index( key ) ); }
+
+    iterator erase( const_iterator pos ) {
+        auto i = static_cast<size_type>( pos.m_ctrl - m_ctrl );
+        erase_index( i );
+        return make_iterator<false>( i + 1, true );
+    }
+
+    void swap( swiss_table& other ) noexcept {
+        using std::swap;
+        swap( m_hash, other.m_hash );
+        swap( m_eq, other.m_eq );
+        swap( m_ctrl, other.m_ctrl );
+        swap( m_slots, other.m_slots );
+        swap( m_capacity, other.m_capacity );
+        swap( m_size, other.m_size );
+        swap( m_growth_left, other.m_growth_left );
+    }
+
+protected:
+    // the slot holding key, or a new slot built from args and the bool says so
+    template< typename K, typename... Args >
+    std::pair<iterator, bool> emplace_key( const K& key, Args&&... args ) {
+        std::uint64_t hash = hash_of( key );
+        size_type i = find_index( key, hash );
+        if ( i != npos ) {
+            return { iterator_at<false>( i ), false };
+        }
+        i = insert_unique( hash, std::forward<Args>( args )... );
+        return { iterator_at<false>( i ), true };
+    }
+
+private:
+    template< typename K >
+    std::uint64_t hash_of( const K& key ) const {
+        return mix_hash( static_cast<std::uint64_t>( m_hash( key ) ) );
+    }
+
+    static ctrl_t h2( std::uint64_t hash ) noexcept { return static_cast<ctrl_t>( hash & 0x7f ); }
+
+    // groups in quadratic (triangular) order, which visits every group of a power of two table
+    class probe {
+    public:
+        probe( std::uint64_t hash, size_type groups ) noexcept
+            : m_mask( groups == 0 ? 0 : groups - 1 ), m_group( static_cast<size_type>( hash >> 7 ) & m_mask ) {}
+        size_type offset() const noexcept { return m_group * group_width; }
+        void next() noexcept { m_group = ( m_group + ++m_step ) & m_mask; }
+
+    private:
+        size_type m_mask;
+        size_type m_group;
+        size_type m_step = 0;
+    };
+
+    template< typename K >
+    size_type find_index( const K& key ) const {
+        return find_index( key, hash_of( key ) );
+    }
+
+    template< typename K >
+    size_type find_index( const K& key, std::uint64_t hash ) const {
+        for ( probe p( hash, m_capacity / group_width );; p.next() ) {
+            ctrl_group g( m_ctrl + p.offset() );
+            for ( std::uint32_t m = g.match( h2( hash ) ); m != 0; m &= m - 1 ) {
+                size_type i = p.offset() + static_cast<size_type>( count_trailing_zeros( m ) );
+                if ( m_eq( key, Policy::key( m_slots[i] ) ) ) {
+                    return i;
+                }
+            }
+            // the key would have gone into this group's empty slot
+            if ( g.match_empty() != 0 ) {
+                return npos;
+            }
+        }
+    }
+
+    size_type find_free( std::uint64_t hash ) const noexcept {
+        for ( probe p( hash, m_capacity / group_width );; p.next() ) {
+            if ( std::uint32_t m = ctrl_group( m_ctrl + p.offset() ).match_free() ) {
+                return p.offset() + static_cast<size_type>( count_trailing_zeros( m ) );
+            }
+        }
+    }
+
+    // the key is known to be missing
+    template< typename... Args >
+    size_type insert_unique( std::uint64_t hash, Args&&... args ) {
+        size_type i = find_free( hash );
+        // reusing a deleted slot costs no growth
+        if ( m_growth_left == 0 && m_ctrl[i] != ctrl_deleted ) {
+            grow();
+            i = find_free( hash );
+        }
+        ::new ( static_cast<void*>( m_slots + i ) ) slot_type( std::forward<Args>( args )... );
+        if ( m_ctrl[i] == ctrl_empty ) {
+            --m_growth_left;
+        }
+        m_ctrl[i] = h2( hash );
+        ++m_size;
+        return i;
+    }
+
+    size_type erase_index( size_type i ) {
+        if ( i == npos ) {
+            return 0;
+        }
+        m_slots[i].~slot_type();
+        --m_size;
+        // a group that already has an empty slot stops every probe, so nothing probes past it
+        if ( ctrl_group( m_ctrl + i / group_width * group_width ).match_empty() != 0 ) {
+            m_ctrl[i] = ctrl_empty;
+            ++m_growth_left;
+        } else {
+            m_ctrl[i] = ctrl_deleted;
+        }
+        return 1;
+    }
+
+    // doubles, or rebuilds at the same size when tombstones are most of the load
+    void grow() {
+        size_type capacity = m_capacity == 0 ? group_width : m_capacity;
+        if ( m_size > capacity / 2 - capacity / 16 ) {
+            capacity = m_capacity == 0 ? group_width : m_capacity * 2;
+        }
+        rehash( capacity );
+    }
+
+    void rehash( size_type capacity ) {
+        swiss_table fresh( 0, m_hash, m_eq );
+        fresh.allocate( capacity );
+        for ( size_type i = 0; i < m_capacity; ++i ) {
+            if ( m_ctrl[i] >= 0 ) {
+                fresh.insert_unique( hash_of( Policy::key( m_slots[i] ) ), std::move( m_slots[i] ) );
+            }
+        }
+        swap_storage( fresh );
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Storage
+    //////////////////////////////////////////////////////////////////////////
+    // control bytes, then the slots, in one allocation
+    static constexpr std::size_t storage_alignment = alignof( slot_type ) > group_width ? alignof( slot_type ) : group_width;
+    static size_type slots_offset( size_type capacity ) noexcept {
+        return ( capacity + alignof( slot_type ) - 1 ) / alignof( slot_type ) * alignof( slot_type );
+    }
+    static size_type storage_bytes( size_type capacity ) noexcept {
+        return slots_offset( capacity ) + capacity * sizeof( slot_type );
+    }
+
+    void allocate( size_type capacity ) {
+        auto* storage = static_cast<unsigned char*>( ::operator new( storage_bytes( capacity ), std::align_val_t( storage_alignment ) ) );
+        m_ctrl = reinterpret_cast<ctrl_t*>( storage );
+        m_slots = reinterpret_cast<slot_type*>( storage + slots_offset( capacity ) );
+        m_capacity = capacity;
+        m_size = 0;
+        m_growth_left = capacity - capacity / 8;
+        std::memset( m_ctrl, static_cast<unsigned char>( ctrl_empty ), capacity );
+    }
+
+    void destroy_all() noexcept {
+        if constexpr ( !std::is_trivially_destructible<slot_type>::value ) {
+            for ( size_type i = 0; i < m_capacity; ++i ) {
+                if ( m_ctrl[i] >= 0 ) {
+                    m_slots[i].~slot_type();
+                }
+            }
+        }
+    }
+
+    void release() noexcept {
+        destroy_all();
+        if ( m_capacity != 0 ) {
+            ::operator delete( m_ctrl, storage_bytes( m_capacity ), std::align_val_t( storage_alignment ) );
+        }
+        reset();
+    }
+
+    void reset() noexcept {
+        m_ctrl = const_cast<ctrl_t*>( empty_group );
+        m_slots = nullptr;
+        m_capacity = 0;
+        m_size = 0;
+        m_growth_left = 0;
+    }
+
+    void swap_storage( swiss_table& other ) noexcept {
+        std::swap( m_ctrl, other.m_ctrl );
+        std::swap( m_slots, other.m_slots );
+        std::swap( m_capacity, other.m_capacity );
+        std::swap( m_size, other.m_size );
+        std::swap( m_growth_left, other.m_growth_left );
+    }
+
+    void steal( swiss_table& other ) noexcept {
+        m_ctrl = other.m_ctrl;
+        m_slots = other.m_slots;
+        m_capacity = other.m_capacity;
+        m_size = other.m_size;
+        m_growth_left = other.m_growth_left;
+        other.reset();
+    }
+
+    template< bool Const >
+    basic_iterator<Const> make_iterator( size_type i, bool skip ) const noexcept {
+        basic_iterator<Const> it( m_ctrl + i, m_slots + i, m_ctrl + m_capacity );
+        if ( skip ) {
+            it.skip_free();
+        }
+        return it;
+    }
+
+    template< bool Const >
+    basic_iterator<Const> iterator_at( size_type i ) const noexcept {
+        return i == npos ? make_iterator<Const>( m_capacity, false ) : make_iterator<Const>( i, false );
+    }
+
+    Hash m_hash;
+    Eq m_eq;
+    // the empty table points at empty_group, which is never written: inserts grow first
+    ctrl_t* m_ctrl = const_cast<ctrl_t*>( empty_group );
+    slot_type* m_slots = nullptr;
+    size_type m_capacity = 0;
+    size_type m_size = 0;
+    size_type m_growth_left = 0;
+};
+
+} // namespace detail
+
+//////////////////////////////////////////////////////////////////////////
+// hash_set
+//////////////////////////////////////////////////////////////////////////
+template< typename Key, typename Hash = std::hash<Key>, typename Eq = std::equal_to<Key> >
+class hash_set : public detail::swiss_table<Key, detail::set_policy<Key>, Hash, Eq> {
+    using base = detail::swiss_table<Key, detail::set_policy<Key>, Hash, Eq>;
+
+public:
+    using iterator = typename base::const_iterator;
+    using const_iterator = typename base::const_iterator;
+
+    using base::base;
+    hash_set() = default;
+    template< typename InputIt >
+    hash_set( InputIt first, InputIt last ) {
+        insert( first, last );
+    }
+    hash_set( std::initializer_list<Key> keys ) { insert( keys.begin(), keys.end() ); }
+
+    // elements are keys and must not change, only const iterators
+    const_iterator begin() const noexcept { return base::begin(); }
+    const_iterator end() const noexcept { return base::end(); }
+
+    std::pair<iterator, bool> insert( const Key& key ) { return this->emplace_key( key, key ); }
+    std::pair<iterator, bool> insert( Key&& key ) { return this->emplace_key( key, std::move( key ) ); }
+
+    template< typename InputIt >
+    void insert( InputIt first, InputIt last ) {
+        for ( ; first != last; ++first ) {
+            insert( *first );
+        }
+    }
+
+    template< typename... Args >
+    std::pair<iterator, bool> emplace( Args&&... args ) {
+        return insert( Key( std::forward<Args>( args )... ) );
+    }
+
+    friend bool operator==( const hash_set& lhs, const hash_set& rhs ) {
+        if ( lhs.size() != rhs.size() ) {
+            return false;
+        }
+        for ( const Key& key : lhs ) {
+            if ( !rhs.contains( key ) ) {
+                return false;
+            }
+        }
+        return true;
+    }
+    friend bool operator!=( const hash_set& lhs, const hash_set& rhs ) { return !( lhs == rhs ); }
+};
+
+//////////////////////////////////////////////////////////////////////////
+// hash_map
+//////////////////////////////////////////////////////////////////////////
+template< typename Key, typename T, typename Hash = std::hash<Key>, typename Eq = std::equal_to<Key> >
+class hash_map : public detail::swiss_table<Key, detail::map_policy<Key, T>, Hash, Eq> {
+    using base = detail::swiss_table<Key, detail::map_policy<Key, T>, Hash, Eq>;
+
+public:
+    using mapped_type = T;
+    using typename base::iterator;
+    using typename base::const_iterator;
+
+    using base::base;
+    hash_map() = default;
+    template< typename InputIt >
+    hash_map( InputIt first, InputIt last ) {
+        insert( first, last );
+    }
+    hash_map( std::initializer_list<std::pair<const Key, T>> values ) { insert( values.begin(), values.end() ); }
+
+    T& operator[]( const Key& key ) { return try_emplace( key ).first->second; }
+    T& operator[]( Key&& key ) { return try_emplace( std::move( key ) ).first->second; }
+
+    T& at( const Key& key ) {
+        auto it = this->find( key );
+        if ( it == this->end() ) {
+            throw std::out_of_range( "perf::hash_map::at" );
+        }
+        return it->second;
+    }
+    const T& at( const Key& key ) const { return const_cast<hash_map&>( *this ).at( key ); }
+
+    // does nothing, and builds no T, when the key is there
+    template< typename... Args >
+    std::pair<iterator, bool> try_emplace( const Key& key, Args&&... args ) {
+        return this->emplace_key( key, std::piecewise_construct, std::forward_as_tuple( key ),
+                                  std::forward_as_tuple( std::forward<Args>( args )... ) );
+    }
+    template< typename... Args >
+    std::pair<iterator, bool> try_emplace( Key&& key, Args&&... args ) {
+        return this->emplace_key( key, std::piecewise_construct, std::forward_as_tuple( std::move( key ) ),
+                                  std::forward_as_tuple( std::forward<Args>( args )... ) );
+    }
+
+    std::pair<iterator, bool> insert( const std::pair<const Key, T>& value ) { return this->emplace_key( value.first, value ); }
+
+    template< typename InputIt >
+    void insert( InputIt first, InputIt last ) {
+        for ( ; first != last; ++first ) {
+            insert( *first );
+        }
+    }
+
+    template< typename V >
+    std::pair<iterator, bool> insert_or_assign( const Key& key, V&& value ) {
+        auto r = try_emplace( key, std::forward<V>( value ) );
+        if ( !r.second ) {
+            r.first->second = std::forward<V>( value );
+        }
+        return r;
+    }
+};
+
+} // namespace perf
+
+#endif  // PERF_HASH_SET_HPP
@@ -0,0 +1,128 @@
+//  perf/histogram.hpp  ------------------------------------------------------//
+
+//  Log-linear histogram for latencies and other non-negative 64-bit values.
+//
+//  Values below 16 get a bucket each, above that every power of two is split
+//  into 8 buckets, so any recorded value is known to within 12.5%. That is
+//  512 buckets for the whole 64-bit range, a fixed 4KB with no allocation.
+//
+//  One thread records, any thread may read: the buckets are relaxed atomics
+//  that the owner updates with a plain load + store, not a locked add.
+
+#ifndef PERF_HISTOGRAM_HPP
+#define PERF_HISTOGRAM_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "simd.hpp"
+
+namespace perf {
+
+class log_histogram {
+public:
+    static constexpr std::size_t bucket_count = 512;
+
+    log_histogram() = default;
+    log_histogram( const log_histogram& other ) { merge( other ); }
+    log_histogram& operator=( const log_histogram& other ) {
+        if ( this != &other ) {
+            clear();
+            merge( other );
+        }
+        return *this;
+    }
+
+    // single writer only
+    void record( std::uint64_t value ) noexcept {
+        auto& b = m_buckets[bucket_of( value )];
+        b.store( b.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+        m_count.store( m_count.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+        m_sum.store( m_sum.load( std::memory_order_relaxed ) + value, std::memory_order_relaxed );
+        if ( value > m_max.load( std::memory_order_relaxed ) ) {
+            m_max.store( value, std::memory_order_relaxed );
+        }
+    }
+
+    // safe to call concurrently with record on `other`, the snapshot may be slightly torn
+    void merge( const log_histogram& other ) noexcept {
+        for ( std::size_t i = 0; i < bucket_count; ++i ) {
+            add( m_buckets[i], other.m_buckets[i].load( std::memory_order_relaxed ) );
+        }
+        add( m_count, other.count() );
+        add( m_sum, other.sum() );
+        if ( other.max() > max() ) {
+            m_max.store( other.max(), std::memory_order_relaxed );
+        }
+    }
+
+    void clear() noexcept {
+        for ( auto& b : m_buckets ) {
+            b.store( 0, std::memory_order_relaxed );
+        }
+        m_count.store( 0, std::memory_order_relaxed );
+        m_sum.store( 0, std::memory_order_relaxed );
+        m_max.store( 0, std::memory_order_relaxed );
+    }
+
+    std::uint64_t count() const noexcept { return m_count.load( std::memory_order_relaxed ); }
+    std::uint64_t sum() const noexcept { return m_sum.load( std::memory_order_relaxed ); }
+    std::uint64_t max() const noexcept { return m_max.load( std::memory_order_relaxed ); }
+    double mean() const noexcept { return count() == 0 ? 0.0 : static_cast<double>( sum() ) / static_cast<double>( count() ); }
+
+    // upper edge of the bucket holding the q-th quantile, q in [0, 1]
+    std::uint64_t percentile( double q ) const noexcept {
+        std::uint64_t total = 0;
+        for ( auto& b : m_buckets ) {
+            total += b.load( std::memory_order_relaxed );
+        }
+        if ( total == 0 ) {
+            return 0;
+        }
+        auto rank = static_cast<std::uint64_t>( q * static_cast<double>( total - 1 ) ) + 1;
+        std::uint64_t seen = 0;
+        for ( std::size_t i = 0; i < bucket_count; ++i ) {
+            seen += m_buckets[i].load( std::memory_order_relaxed );
+            if ( seen >= rank ) {
+                std::uint64_t upper = bucket_upper( i );
+                return upper < max() ? upper : max();
+            }
+        }
+        return max();
+    }
+
+    static std::size_t bucket_of( std::uint64_t v ) noexcept {
+        if ( v < 16 ) {
+            return static_cast<std::size_t>( v );
+        }
+        int exponent = 63 - count_leading_zeros( v );
+        auto sub = static_cast<std::size_t>( ( v >> ( exponent - 3 ) ) & 7 );
+        return 16 + static_cast<std::size_t>( exponent - 4 ) * 8 + sub;
+    }
+
+    static std::uint64_t bucket_upper( std::size_t i ) noexcept {
+        if ( i < 16 ) {
+            return i;
+        }
+        int exponent = static_cast<int>( ( i - 16 ) / 8 ) + 4;
+        std::uint64_t sub = ( i - 16 ) % 8;
+        std::uint64_t lower = ( std::uint64_t{ 8 } + sub ) << ( exponent - 3 );
+        return lower + ( ( std::uint64_t{ 1 } << ( exponent - 3 ) ) - 1 );
+    }
+
+private:
+    static void add( std::atomic<std::uint64_t>& a, std::uint64_t v ) noexcept {
+        a.store( a.load( std::memory_order_relaxed ) + v, std::memory_order_relaxed );
+    }
+
+    std::array<std::atomic<std::uint64_t>, bucket_count> m_buckets{};
+    std::atomic<std::uint64_t> m_count{ 0 };
+    std::atomic<std::uint64_t> m_sum{ 0 };
+    std::atomic<std::uint64_t> m_max{ 0 };
+};
+
+} // namespace perf
+
+#endif  // PERF_HISTOGRAM_HPP
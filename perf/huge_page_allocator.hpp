@@ -0,0 +1,143 @@
+//  perf/huge_page_allocator.hpp  --------------------------------------------//
+
+//  An allocator that backs large blocks with 2MB pages.
+//
+//  A scan over a multi-gigabyte buffer in 4KB pages touches a new page every
+//  1024 ints, and random access into it misses the TLB almost every time. With
+//  2MB pages one TLB entry covers 512 times as much memory.
+//
+//      perf::huge_page_vector<int> results;
+//      results.resize( 1'000'000'000 );
+//
+//  Blocks below Threshold come from operator new as usual. Larger blocks are
+//  rounded up to whole huge pages and mapped directly:
+//
+//   1. explicit huge pages, mmap( MAP_HUGETLB ), when the administrator has
+//      reserved some (vm.nr_hugepages)
+//   2. otherwise an anonymous mapping aligned to 2MB with
+//      madvise( MADV_HUGEPAGE ), which asks for transparent huge pages when
+//      they are enabled in "always" or "madvise" mode and is harmless when not
+//
+//  Either way the memory works, huge pages or not; only the speed differs.
+//  On platforms without mmap every block comes from operator new.
+
+#ifndef PERF_HUGE_PAGE_ALLOCATOR_HPP
+#define PERF_HUGE_PAGE_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#define PERF_HUGE_PAGES 1
+#else
+#define PERF_HUGE_PAGES 0
+#endif
+
+namespace perf {
+
+constexpr std::size_t huge_page_size = std::size_t{ 2 } << 20;
+
+namespace detail {
+
+inline std::size_t round_to_huge_pages( std::size_t bytes ) noexcept {
+    return ( bytes + huge_page_size - 1 ) & ~( huge_page_size - 1 );
+}
+
+#if PERF_HUGE_PAGES
+// bytes must be a multiple of huge_page_size
+inline void* map_huge_pages( std::size_t bytes ) {
+#if defined(MAP_HUGETLB)
+    void* p = ::mmap( nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0 );
+    if ( p != MAP_FAILED ) {
+        return p;
+    }
+#endif
+    // no reserved pages: over-map by one huge page and trim to 2MB alignment,
+    // transparent huge pages only back aligned 2MB ranges
+    std::size_t padded = bytes + huge_page_size;
+    void* raw = ::mmap( nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+    if ( raw == MAP_FAILED ) {
+        throw std::bad_alloc();
+    }
+    auto begin = reinterpret_cast<std::uintptr_t>( raw );
+    auto aligned = ( begin + huge_page_size - 1 ) & ~std::uintptr_t( huge_page_size - 1 );
+    std::size_t head = aligned - begin;
+    if ( head != 0 ) {
+        ::munmap( raw, head );
+    }
+    if ( std::size_t tail = huge_page_size - head ) {
+        ::munmap( reinterpret_cast<void*>( aligned + bytes ), tail );
+    }
+    p = reinterpret_cast<void*>( aligned );
+#if defined(MADV_HUGEPAGE)
+    ::madvise( p, bytes, MADV_HUGEPAGE );
+#endif
+    return p;
+}
+
+inline void unmap_huge_pages( void* p, std::size_t bytes ) noexcept {
+    ::munmap( p, bytes );
+}
+#endif
+
+} // namespace detail
+
+//////////////////////////////////////////////////////////////////////////
+// huge_page_allocator
+//////////////////////////////////////////////////////////////////////////
+// blocks of at least Threshold bytes are backed by huge pages when the system has them
+template< typename T, std::size_t Threshold = huge_page_size >
+class huge_page_allocator {
+    static_assert( alignof( T ) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "over-aligned types are not supported" );
+
+public:
+    using value_type = T;
+
+    template< typename U >
+    struct rebind {
+        using other = huge_page_allocator<U, Threshold>;
+    };
+
+    huge_page_allocator() noexcept = default;
+    template< typename U >
+    huge_page_allocator( const huge_page_allocator<U, Threshold>& ) noexcept {}
+
+    T* allocate( std::size_t n ) {
+        // leave room to round up and pad to a huge page
+        if ( n > ( std::numeric_limits<std::size_t>::max() - 2 * huge_page_size ) / sizeof( T ) ) {
+            throw std::bad_array_new_length();
+        }
+        std::size_t bytes = n * sizeof( T );
+#if PERF_HUGE_PAGES
+        if ( bytes >= Threshold ) {
+            return static_cast<T*>( detail::map_huge_pages( detail::round_to_huge_pages( bytes ) ) );
+        }
+#endif
+        return static_cast<T*>( ::operator new( bytes ) );
+    }
+
+    void deallocate( T* p, std::size_t n ) noexcept {
+        std::size_t bytes = n * sizeof( T );
+#if PERF_HUGE_PAGES
+        if ( bytes >= Threshold ) {
+            detail::unmap_huge_pages( p, detail::round_to_huge_pages( bytes ) );
+            return;
+        }
+#endif
+        ::operator delete( p );
+    }
+
+    friend bool operator==( const huge_page_allocator&, const huge_page_allocator& ) noexcept { return true; }
+    friend bool operator!=( const huge_page_allocator&, const huge_page_allocator& ) noexcept { return false; }
+};
+
+template< typename T >
+using huge_page_vector = std::vector<T, huge_page_allocator<T>>;
+
+} // namespace perf
+
+#endif  // PERF_HUGE_PAGE_ALLOCATOR_HPP
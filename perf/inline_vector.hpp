@@ -0,0 +1,687 @@
+//  perf/inline_vector.hpp  --------------------------------------------------//
+
+//  Vectors that keep their elements inside the object, for the many
+//  collections whose size is dynamic but small and bounded.
+//
+//  std::array needs the size at compile time, std::vector pays a heap
+//  allocation (and a pointer chase on every access) for even one element.
+//
+//  static_vector<T, N>   up to N elements, inline, never allocates. Going past N
+//                        throws std::bad_alloc, like std::inplace_vector; use
+//                        try_emplace_back where overflow is expected
+//  small_vector<T, N>    the first N elements inline, past that it moves to the
+//                        heap and grows like perf::vector
+//
+//  Both are built on perf/uninitialized.hpp, so trivially copyable types are
+//  copied with memcpy and trivially relocatable types shifted with memmove.
+//  Element types need a noexcept move constructor unless they are trivially
+//  relocatable. Unlike std::vector, moving either container moves the
+//  elements one by one (small_vector only when they are inline), and moving
+//  leaves the source empty.
+
+#ifndef PERF_INLINE_VECTOR_HPP
+#define PERF_INLINE_VECTOR_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "uninitialized.hpp"
+
+namespace perf {
+
+namespace detail {
+
+// copy-constructs n objects into raw storage, memcpy for trivially copyable types
+template< typename T >
+void copy_construct_n( const T* first, std::size_t n, T* dest ) {
+    if constexpr ( std::is_trivially_copyable<T>::value ) {
+        if ( n != 0 ) {
+            std::memcpy( static_cast<void*>( dest ), static_cast<const void*>( first ), n * sizeof( T ) );
+        }
+    } else {
+        std::uninitialized_copy( first, first + n, dest );
+    }
+}
+
+template< typename It >
+using if_input_iterator = std::enable_if_t<
+    std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<It>::iterator_category>::value, int>;
+
+} // namespace detail
+
+//////////////////////////////////////////////////////////////////////////
+// static_vector
+//////////////////////////////////////////////////////////////////////////
+template< typename T, std::size_t N >
+class static_vector {
+    static_assert( N > 0, "a static_vector needs room for at least one element" );
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    //////////////////////////////////////////////////////////////////////////
+    // Construction
+    //////////////////////////////////////////////////////////////////////////
+    static_vector() noexcept {}
+
+    explicit static_vector( size_type n ) { resize( n ); }
+    static_vector( size_type n, const T& value ) { resize( n, value ); }
+    template< typename InputIt, detail::if_input_iterator<InputIt> = 0 >
+    static_vector( InputIt first, InputIt last ) {
+        assign( first, last );
+    }
+    static_vector( std::initializer_list<T> values ) { assign( values.begin(), values.end() ); }
+
+    static_vector( const static_vector& other ) {
+        detail::copy_construct_n( other.data(), other.m_size, data() );
+        m_size = other.m_size;
+    }
+
+    static_vector( static_vector&& other ) noexcept { take( other ); }
+
+    // no copy-and-swap: swapping inline elements is no cheaper than copying them
+    static_vector& operator=( const static_vector& other ) {
+        if ( this != &other ) {
+            clear();
+            detail::copy_construct_n( other.data(), other.m_size, data() );
+            m_size = other.m_size;
+        }
+        return *this;
+    }
+
+    static_vector& operator=( static_vector&& other ) noexcept {
+        if ( this != &other ) {
+            clear();
+            take( other );
+        }
+        return *this;
+    }
+
+    static_vector& operator=( std::initializer_list<T> values ) {
+        assign( values.begin(), values.end() );
+        return *this;
+    }
+
+    ~static_vector() { destroy_n( data(), m_size ); }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Access
+    //////////////////////////////////////////////////////////////////////////
+    size_type size() const noexcept { return m_size; }
+    static constexpr size_type capacity() noexcept { return N; }
+    static constexpr size_type max_size() noexcept { return N; }
+    bool empty() const noexcept { return m_size == 0; }
+    bool full() const noexcept { return m_size == N; }
+
+    T* data() noexcept { return reinterpret_cast<T*>( m_storage ); }
+    const T* data() const noexcept { return reinterpret_cast<const T*>( m_storage ); }
+
+    iterator begin() noexcept { return data(); }
+    iterator end() noexcept { return data() + m_size; }
+    const_iterator begin() const noexcept { return data(); }
+    const_iterator end() const noexcept { return data() + m_size; }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    T& operator[]( size_type i ) noexcept { assert( i < m_size ); return data()[i]; }
+    const T& operator[]( size_type i ) const noexcept { assert( i < m_size ); return data()[i]; }
+    T& at( size_type i ) { return i < m_size ? data()[i] : throw std::out_of_range( "perf::static_vector::at" ); }
+    const T& at( size_type i ) const { return i < m_size ? data()[i] : throw std::out_of_range( "perf::static_vector::at" ); }
+    T& front() noexcept { return ( *this )[0]; }
+    const T& front() const noexcept { return ( *this )[0]; }
+    T& back() noexcept { return ( *this )[m_size - 1]; }
+    const T& back() const noexcept { return ( *this )[m_size - 1]; }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Capacity
+    //////////////////////////////////////////////////////////////////////////
+    // nothing to allocate, only checks that n fits
+    void reserve( size_type n ) {
+        if ( n > N ) {
+            overflow();
+        }
+    }
+
+    template< typename... Value >
+    void resize( size_type n, const Value&... value ) {
+        static_assert( sizeof...( Value ) <= 1, "resize(n) or resize(n, value)" );
+        if ( n > m_size ) {
+            reserve( n );
+            construct_n( data() + m_size, n - m_size, value... );
+        } else {
+            destroy_n( data() + n, m_size - n );
+        }
+        m_size = n;
+    }
+
+    // like resize(n), but new elements are default-initialized: for trivial types
+    // nothing is written, the caller is expected to overwrite them all
+    void resize_uninitialized( size_type n ) {
+        if ( n > m_size ) {
+            reserve( n );
+            default_construct_n( data() + m_size, n - m_size );
+        } else {
+            destroy_n( data() + n, m_size - n );
+        }
+        m_size = n;
+    }
+
+    void clear() noexcept {
+        destroy_n( data(), m_size );
+        m_size = 0;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Modifiers
+    //////////////////////////////////////////////////////////////////////////
+    void assign( size_type n, const T& value ) {
+        reserve( n );
+        // the value may be one of the elements about to go
+        T copy( value );
+        clear();
+        construct_n( data(), n, copy );
+        m_size = n;
+    }
+
+    template< typename InputIt, detail::if_input_iterator<InputIt> = 0 >
+    void assign( InputIt first, InputIt last ) {
+        clear();
+        for ( ; first != last; ++first ) {
+            emplace_back( *first );
+        }
+    }
+
+    void assign( std::initializer_list<T> values ) { assign( values.begin(), values.end() ); }
+
+    template< typename... Args >
+    T& emplace_back( Args&&... args ) {
+        if ( m_size == N ) {
+            overflow();
+        }
+        return unchecked_emplace_back( std::forward<Args>( args )... );
+    }
+
+    // nullptr instead of an exception when full
+    template< typename... Args >
+    T* try_emplace_back( Args&&... args ) {
+        return m_size == N ? nullptr : &unchecked_emplace_back( std::forward<Args>( args )... );
+    }
+
+    void push_back( const T& value ) { emplace_back( value ); }
+    void push_back( T&& value ) { emplace_back( std::move( value ) ); }
+
+    void pop_back() noexcept {
+        assert( m_size > 0 );
+        destroy_n( data() + --m_size, 1 );
+    }
+
+    template< typename... Args >
+    iterator emplace( const_iterator pos, Args&&... args ) {
+        auto i = static_cast<size_type>( pos - data() );
+        if ( m_size == N ) {
+            overflow();
+        }
+        if ( i == m_size ) {
+            return &unchecked_emplace_back( std::forward<Args>( args )... );
+        }
+        // build first, the arguments may refer to elements that are about to shift
+        T value( std::forward<Args>( args )... );
+        relocate_n( data() + i, m_size - i, data() + i + 1 );
+        new ( static_cast<void*>( data() + i ) ) T( std::move( value ) );
+        ++m_size;
+        return data() + i;
+    }
+
+    iterator insert( const_iterator pos, const T& value ) { return emplace( pos, value ); }
+    iterator insert( const_iterator pos, T&& value ) { return emplace( pos, std::move( value ) ); }
+
+    iterator insert( const_iterator pos, size_type n, const T& value ) {
+        auto i = static_cast<size_type>( pos - data() );
+        if ( n > N - m_size ) {
+            overflow();
+        }
+        // the value may be one of the elements that shift
+        T copy( value );
+        relocate_n( data() + i, m_size - i, data() + i + n );
+        try {
+            construct_n( data() + i, n, copy );
+        } catch ( ... ) {
+            relocate_n( data() + i + n, m_size - i, data() + i );
+            throw;
+        }
+        m_size += n;
+        return data() + i;
+    }
+
+    iterator erase( const_iterator first, const_iterator last ) noexcept {
+        auto i = static_cast<size_type>( first - data() );
+        auto n = static_cast<size_type>( last - first );
+        destroy_n( data() + i, n );
+        relocate_n( data() + i + n, m_size - i - n, data() + i );
+        m_size -= n;
+        return data() + i;
+    }
+
+    iterator erase( const_iterator pos ) noexcept { return erase( pos, pos + 1 ); }
+
+    void swap( static_vector& other ) noexcept {
+        static_vector* shorter = m_size < other.m_size ? this : &other;
+        static_vector* longer = shorter == this ? &other : this;
+        using std::swap;
+        for ( size_type i = 0; i < shorter->m_size; ++i ) {
+            swap( shorter->data()[i], longer->data()[i] );
+        }
+        relocate_n( longer->data() + shorter->m_size, longer->m_size - shorter->m_size, shorter->data() + shorter->m_size );
+        std::swap( m_size, other.m_size );
+    }
+    friend void swap( static_vector& lhs, static_vector& rhs ) noexcept { lhs.swap( rhs ); }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Comparison operators
+    //////////////////////////////////////////////////////////////////////////
+    friend bool operator==( const static_vector& lhs, const static_vector& rhs ) {
+        return std::equal( lhs.begin(), lhs.end(), rhs.begin(), rhs.end() );
+    }
+    friend bool operator<( const static_vector& lhs, const static_vector& rhs ) {
+        return std::lexicographical_compare( lhs.begin(), lhs.end(), rhs.begin(), rhs.end() );
+    }
+    friend bool operator!=( const static_vector& lhs, const static_vector& rhs ) { return !( lhs == rhs ); }
+    friend bool operator>( const static_vector& lhs, const static_vector& rhs ) { return rhs < lhs; }
+    friend bool operator<=( const static_vector& lhs, const static_vector& rhs ) { return !( rhs < lhs ); }
+    friend bool operator>=( const static_vector& lhs, const static_vector& rhs ) { return !( lhs < rhs ); }
+
+private:
+    [[noreturn]] static void overflow() { throw std::bad_alloc(); }
+
+    template< typename... Args >
+    T& unchecked_emplace_back( Args&&... args ) {
+        T* p = new ( static_cast<void*>( data() + m_size ) ) T( std::forward<Args>( args )... );
+        ++m_size;
+        return *p;
+    }
+
+    // relocates the elements of other into this empty vector
+    void take( static_vector& other ) noexcept {
+        relocate_n( other.data(), other.m_size, data() );
+        m_size = other.m_size;
+        other.m_size = 0;
+    }
+
+    size_type m_size = 0;
+    alignas( T ) unsigned char m_storage[N * sizeof( T )];
+};
+
+// no pointers into itself, so it relocates exactly when its elements do
+template< typename T, std::size_t N >
+struct is_trivially_relocatable<static_vector<T, N>> : is_trivially_relocatable<T> {};
+
+//////////////////////////////////////////////////////////////////////////
+// small_vector
+//////////////////////////////////////////////////////////////////////////
+template< typename T, std::size_t N >
+class small_vector {
+    static_assert( N > 0, "use perf::vector for a small_vector without inline elements" );
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    //////////////////////////////////////////////////////////////////////////
+    // Construction
+    //////////////////////////////////////////////////////////////////////////
+    small_vector() noexcept {}
+
+    explicit small_vector( size_type n ) { resize( n ); }
+    small_vector( size_type n, const T& value ) { resize( n, value ); }
+    template< typename InputIt, detail::if_input_iterator<InputIt> = 0 >
+    small_vector( InputIt first, InputIt last ) {
+        assign( first, last );
+    }
+    small_vector( std::initializer_list<T> values ) { assign( values.begin(), values.end() ); }
+
+    small_vector( const small_vector& other ) {
+        reserve( other.m_size );
+        detail::copy_construct_n( other.m_data, other.m_size, m_data );
+        m_size = other.m_size;
+    }
+
+    small_vector( small_vector&& other ) noexcept { take( other ); }
+
+    small_vector& operator=( const small_vector& other ) {
+        if ( this != &other ) {
+            clear();
+            reserve( other.m_size );
+            detail::copy_construct_n( other.m_data, other.m_size, m_data );
+            m_size = other.m_size;
+        }
+        return *this;
+    }
+
+    small_vector& operator=( small_vector&& other ) noexcept {
+        if ( this != &other ) {
+            clear();
+            release();
+            take( other );
+        }
+        return *this;
+    }
+
+    small_vector& operator=( std::initializer_list<T> values ) {
+        assign( values.begin(), values.end() );
+        return *this;
+    }
+
+    ~small_vector() {
+        destroy_n( m_data, m_size );
+        release();
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Access
+    //////////////////////////////////////////////////////////////////////////
+    size_type size() const noexcept { return m_size; }
+    size_type capacity() const noexcept { return m_capacity; }
+    static constexpr size_type inline_capacity() noexcept { return N; }
+    bool empty() const noexcept { return m_size == 0; }
+    // false once the elements have moved to the heap
+    bool is_inline() const noexcept { return m_data == inline_data(); }
+
+    T* data() noexcept { return m_data; }
+    const T* data() const noexcept { return m_data; }
+
+    iterator begin() noexcept { return m_data; }
+    iterator end() noexcept { return m_data + m_size; }
+    const_iterator begin() const noexcept { return m_data; }
+    const_iterator end() const noexcept { return m_data + m_size; }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    T& operator[]( size_type i ) noexcept { assert( i < m_size ); return m_data[i]; }
+    const T& operator[]( size_type i ) const noexcept { assert( i < m_size ); return m_data[i]; }
+    T& at( size_type i ) { return i < m_size ? m_data[i] : throw std::out_of_range( "perf::small_vector::at" ); }
+    const T& at( size_type i ) const { return i < m_size ? m_data[i] : throw std::out_of_range( "perf::small_vector::at" ); }
+    T& front() noexcept { return ( *this )[0]; }
+    const T& front() const noexcept { return ( *this )[0]; }
+    T& back() noexcept { return ( *this )[m_size - 1]; }
+    const T& back() const noexcept { return ( *this )[m_size - 1]; }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Capacity
+    //////////////////////////////////////////////////////////////////////////
+    void reserve( size_type n ) {
+        if ( n > m_capacity ) {
+            T* fresh = std::allocator<T>{}.allocate( n );
+            relocate_n( m_data, m_size, fresh );
+            release();
+            m_data = fresh;
+            m_capacity = n;
+        }
+    }
+
+    // back into the inline elements when they fit, otherwise down to size()
+    void shrink_to_fit() {
+        if ( is_inline() || m_size == m_capacity ) {
+            return;
+        }
+        T* fresh = m_size <= N ? inline_data() : std::allocator<T>{}.allocate( m_size );
+        relocate_n( m_data, m_size, fresh );
+        release();
+        m_data = fresh;
+        m_capacity = m_size <= N ? N : m_size;
+    }
+
+    template< typename... Value >
+    void resize( size_type n, const Value&... value ) {
+        static_assert( sizeof...( Value ) <= 1, "resize(n) or resize(n, value)" );
+        if ( n > m_size ) {
+            if ( n > m_capacity ) {
+                reallocate_resize( n, value... );
+                return;
+            }
+            construct_n( m_data + m_size, n - m_size, value... );
+        } else {
+            destroy_n( m_data + n, m_size - n );
+        }
+        m_size = n;
+    }
+
+    // like resize(n), but new elements are default-initialized: for trivial types
+    // nothing is written, the caller is expected to overwrite them all
+    void resize_uninitialized( size_type n ) {
+        if ( n > m_size ) {
+            if ( n > m_capacity ) {
+                reserve( std::max( n, grown_capacity() ) );
+            }
+            default_construct_n( m_data + m_size, n - m_size );
+        } else {
+            destroy_n( m_data + n, m_size - n );
+        }
+        m_size = n;
+    }
+
+    void clear() noexcept {
+        destroy_n( m_data, m_size );
+        m_size = 0;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Modifiers
+    //////////////////////////////////////////////////////////////////////////
+    void assign( size_type n, const T& value ) {
+        // the value may be one of the elements about to go
+        T copy( value );
+        clear();
+        reserve( n );
+        construct_n( m_data, n, copy );
+        m_size = n;
+    }
+
+    template< typename InputIt, detail::if_input_iterator<InputIt> = 0 >
+    void assign( InputIt first, InputIt last ) {
+        clear();
+        if constexpr ( std::is_base_of<std::forward_iterator_tag,
+                                       typename std::iterator_traits<InputIt>::iterator_category>::value ) {
+            reserve( static_cast<size_type>( std::distance( first, last ) ) );
+        }
+        for ( ; first != last; ++first ) {
+            emplace_back( *first );
+        }
+    }
+
+    void assign( std::initializer_list<T> values ) { assign( values.begin(), values.end() ); }
+
+    template< typename... Args >
+    T& emplace_back( Args&&... args ) {
+        if ( m_size == m_capacity ) {
+            return *reallocate_emplace( m_size, std::forward<Args>( args )... );
+        }
+        T* p = new ( static_cast<void*>( m_data + m_size ) ) T( std::forward<Args>( args )... );
+        ++m_size;
+        return *p;
+    }
+
+    void push_back( const T& value ) { emplace_back( value ); }
+    void push_back( T&& value ) { emplace_back( std::move( value ) ); }
+
+    void pop_back() noexcept {
+        assert( m_size > 0 );
+        destroy_n( m_data + --m_size, 1 );
+    }
+
+    template< typename... Args >
+    iterator emplace( const_iterator pos, Args&&... args ) {
+        auto i = static_cast<size_type>( pos - m_data );
+        if ( m_size == m_capacity ) {
+            return reallocate_emplace( i, std::forward<Args>( args )... );
+        }
+        if ( i == m_size ) {
+            return &emplace_back( std::forward<Args>( args )... );
+        }
+        // build first, the arguments may refer to elements that are about to shift
+        T value( std::forward<Args>( args )... );
+        relocate_n( m_data + i, m_size - i, m_data + i + 1 );
+        new ( static_cast<void*>( m_data + i ) ) T( std::move( value ) );
+        ++m_size;
+        return m_data + i;
+    }
+
+    iterator insert( const_iterator pos, const T& value ) { return emplace( pos, value ); }
+    iterator insert( const_iterator pos, T&& value ) { return emplace( pos, std::move( value ) ); }
+
+    iterator insert( const_iterator pos, size_type n, const T& value ) {
+        auto i = static_cast<size_type>( pos - m_data );
+        // the value may be one of the elements that move
+        T copy( value );
+        if ( n > m_capacity - m_size ) {
+            reserve( std::max( m_size + n, grown_capacity() ) );
+        }
+        relocate_n( m_data + i, m_size - i, m_data + i + n );
+        try {
+            construct_n( m_data + i, n, copy );
+        } catch ( ... ) {
+            relocate_n( m_data + i + n, m_size - i, m_data + i );
+            throw;
+        }
+        m_size += n;
+        return m_data + i;
+    }
+
+    iterator erase( const_iterator first, const_iterator last ) noexcept {
+        auto i = static_cast<size_type>( first - m_data );
+        auto n = static_cast<size_type>( last - first );
+        destroy_n( m_data + i, n );
+        relocate_n( m_data + i + n, m_size - i - n, m_data + i );
+        m_size -= n;
+        return m_data + i;
+    }
+
+    iterator erase( const_iterator pos ) noexcept { return erase( pos, pos + 1 ); }
+
+    void swap( small_vector& other ) noexcept {
+        if ( !is_inline() && !other.is_inline() ) {
+            std::swap( m_data, other.m_data );
+            std::swap( m_size, other.m_size );
+            std::swap( m_capacity, other.m_capacity );
+            return;
+        }
+        small_vector tmp( std::move( other ) );
+        other = std::move( *this );
+        *this = std::move( tmp );
+    }
+    friend void swap( small_vector& lhs, small_vector& rhs ) noexcept { lhs.swap( rhs ); }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Comparison operators
+    //////////////////////////////////////////////////////////////////////////
+    friend bool operator==( const small_vector& lhs, const small_vector& rhs ) {
+        return std::equal( lhs.begin(), lhs.end(), rhs.begin(), rhs.end() );
+    }
+    friend bool operator<( const small_vector& lhs, const small_vector& rhs ) {
+        return std::lexicographical_compare( lhs.begin(), lhs.end(), rhs.begin(), rhs.end() );
+    }
+    friend bool operator!=( const small_vector& lhs, const small_vector& rhs ) { return !( lhs == rhs ); }
+    friend bool operator>( const small_vector& lhs, const small_vector& rhs ) { return rhs < lhs; }
+    friend bool operator<=( const small_vector& lhs, const small_vector& rhs ) { return !( rhs < lhs ); }
+    friend bool operator>=( const small_vector& lhs, const small_vector& rhs ) { return !( lhs < rhs ); }
+
+private:
+    T* inline_data() noexcept { return reinterpret_cast<T*>( m_storage ); }
+    const T* inline_data() const noexcept { return reinterpret_cast<const T*>( m_storage ); }
+
+    // frees the heap block, if any, and points back at the inline elements; size is untouched
+    void release() noexcept {
+        if ( !is_inline() ) {
+            std::allocator<T>{}.deallocate( m_data, m_capacity );
+            m_data = inline_data();
+            m_capacity = N;
+        }
+    }
+
+    // moves the elements of other into this empty inline vector, stealing its heap block if it has one
+    void take( small_vector& other ) noexcept {
+        if ( other.is_inline() ) {
+            relocate_n( other.m_data, other.m_size, m_data );
+        } else {
+            m_data = other.m_data;
+            m_capacity = other.m_capacity;
+            other.m_data = other.inline_data();
+            other.m_capacity = N;
+        }
+        m_size = other.m_size;
+        other.m_size = 0;
+    }
+
+    size_type grown_capacity() const noexcept { return m_capacity * 2; }
+
+    // grow and construct the new element at index i in one pass over the old elements
+    template< typename... Args >
+    T* reallocate_emplace( size_type i, Args&&... args ) {
+        size_type capacity = grown_capacity();
+        T* fresh = std::allocator<T>{}.allocate( capacity );
+        try {
+            new ( static_cast<void*>( fresh + i ) ) T( std::forward<Args>( args )... );
+        } catch ( ... ) {
+            std::allocator<T>{}.deallocate( fresh, capacity );
+            throw;
+        }
+        relocate_n( m_data, i, fresh );
+        relocate_n( m_data + i, m_size - i, fresh + i + 1 );
+        release();
+        m_data = fresh;
+        m_capacity = capacity;
+        ++m_size;
+        return fresh + i;
+    }
+
+    // grow to hold n, the new tail is built before the old elements move
+    // so value may refer to one of them, as in v.resize( n, v[0] )
+    template< typename... Value >
+    void reallocate_resize( size_type n, const Value&... value ) {
+        size_type capacity = std::max( n, grown_capacity() );
+        T* fresh = std::allocator<T>{}.allocate( capacity );
+        try {
+            construct_n( fresh + m_size, n - m_size, value... );
+        } catch ( ... ) {
+            std::allocator<T>{}.deallocate( fresh, capacity );
+            throw;
+        }
+        relocate_n( m_data, m_size, fresh );
+        release();
+        m_data = fresh;
+        m_capacity = capacity;
+        m_size = n;
+    }
+
+    T* m_data = inline_data();
+    size_type m_size = 0;
+    size_type m_capacity = N;
+    alignas( T ) unsigned char m_storage[N * sizeof( T )];
+};
+
+} // namespace perf
+
+#endif  // PERF_INLINE_VECTOR_HPP
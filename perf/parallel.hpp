@@ -0,0 +1,205 @@
+//  perf/parallel.hpp  -------------------------------------------------------//
+
+//  Minimal fork/join helpers for the multithreaded modes of the perf headers.
+//
+//  Algorithms that have a multithreaded mode take perf::parallel as their
+//  first argument, in the spirit of std::execution::par. Small inputs stay on
+//  the calling thread, handing work to other threads costs microseconds.
+//
+//  The work runs on a thread_pool, by default one shared by the process with
+//  a worker per hardware thread minus one (the caller works too). To control
+//  the thread count pass perf::parallel.on( my_pool ).
+
+#ifndef PERF_PARALLEL_HPP
+#define PERF_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace perf {
+
+inline unsigned hardware_threads() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// thread_pool
+//////////////////////////////////////////////////////////////////////////
+// runs one indexed job at a time across its workers and the calling thread
+class thread_pool {
+public:
+    // workers in addition to the thread that calls run
+    explicit thread_pool( unsigned workers ) {
+        m_threads.reserve( workers );
+        for ( unsigned i = 0; i < workers; ++i ) {
+            m_threads.emplace_back( [this] { worker_loop(); } );
+        }
+    }
+    thread_pool( const thread_pool& ) = delete;
+    thread_pool& operator=( const thread_pool& ) = delete;
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> _{ m_mutex };
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for ( auto& t : m_threads ) {
+            t.join();
+        }
+    }
+
+    // threads that take part in run, including the caller
+    unsigned concurrency() const noexcept { return static_cast<unsigned>( m_threads.size() ) + 1; }
+
+    // calls f(i) for every i in [0, n), indices are handed out in increasing order
+    // returns when all calls are done, rethrows the first exception thrown by f
+    // run from inside a job executes inline
+    template< typename F >
+    void run( std::size_t n, F&& f ) {
+        if ( n == 0 ) {
+            return;
+        }
+        if ( m_threads.empty() || n == 1 || inside_job() ) {
+            for ( std::size_t i = 0; i < n; ++i ) {
+                f( i );
+            }
+            return;
+        }
+        std::lock_guard<std::mutex> one_job_at_a_time{ m_run_mutex };
+        job j( &invoke<std::remove_reference_t<F>>, &f, n );
+        {
+            std::lock_guard<std::mutex> _{ m_mutex };
+            m_job = &j;
+            ++m_generation;
+        }
+        m_wake.notify_all();
+        work_on( j );
+        {
+            std::unique_lock<std::mutex> lock{ m_mutex };
+            m_done.wait( lock, [&j] { return j.active == 0 && j.done.load( std::memory_order_acquire ) == j.n; } );
+            m_job = nullptr;
+        }
+        if ( j.error ) {
+            std::rethrow_exception( j.error );
+        }
+    }
+
+    // hardware_threads() - 1 workers, created on first use
+    static thread_pool& shared() {
+        static thread_pool pool( hardware_threads() - 1 );
+        return pool;
+    }
+
+private:
+    struct job {
+        job( void ( *c )( void*, std::size_t ), void* fn, std::size_t count ) : call( c ), f( fn ), n( count ) {}
+
+        void ( *call )( void*, std::size_t );
+        void* f;
+        std::size_t n;
+        std::atomic<std::size_t> next{ 0 };
+        std::atomic<std::size_t> done{ 0 };
+        unsigned active = 0;   // workers inside work_on, guarded by m_mutex
+        std::exception_ptr error;
+        std::once_flag error_once;
+    };
+
+    template< typename F >
+    static void invoke( void* f, std::size_t i ) {
+        ( *static_cast<F*>( f ) )( i );
+    }
+
+    static bool& inside_job() noexcept {
+        thread_local bool inside = false;
+        return inside;
+    }
+
+    static void work_on( job& j ) {
+        bool& inside = inside_job();
+        bool was_inside = inside;
+        inside = true;
+        for ( std::size_t i; ( i = j.next.fetch_add( 1, std::memory_order_relaxed ) ) < j.n; ) {
+            try {
+                j.call( j.f, i );
+            } catch ( ... ) {
+                std::call_once( j.error_once, [&j] { j.error = std::current_exception(); } );
+            }
+            j.done.fetch_add( 1, std::memory_order_release );
+        }
+        inside = was_inside;
+    }
+
+    void worker_loop() {
+        std::uint64_t seen = 0;
+        for ( ;; ) {
+            job* j;
+            {
+                std::unique_lock<std::mutex> lock{ m_mutex };
+                m_wake.wait( lock, [&] { return m_stop || ( m_job != nullptr && m_generation != seen ); } );
+                if ( m_stop ) {
+                    return;
+                }
+                seen = m_generation;
+                j = m_job;
+                ++j->active;
+            }
+            work_on( *j );
+            {
+                std::lock_guard<std::mutex> _{ m_mutex };
+                --j->active;
+            }
+            // j may be gone by now, only touch the pool
+            m_done.notify_all();
+        }
+    }
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_run_mutex;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    job* m_job = nullptr;
+    std::uint64_t m_generation = 0;
+    bool m_stop = false;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Execution policy tag
+//////////////////////////////////////////////////////////////////////////
+struct parallel_t {
+    thread_pool* m_pool = nullptr;
+
+    // the same policy, running on a specific pool
+    constexpr parallel_t on( thread_pool& pool ) const noexcept { return parallel_t{ &pool }; }
+    thread_pool& pool() const { return m_pool != nullptr ? *m_pool : thread_pool::shared(); }
+};
+inline constexpr parallel_t parallel{};
+
+// how many chunks of at least min_chunk elements to split n elements into
+inline std::size_t chunk_count( std::size_t n, std::size_t min_chunk, unsigned threads = hardware_threads() ) {
+    std::size_t chunks = n / std::max<std::size_t>( min_chunk, 1 );
+    return std::max<std::size_t>( 1, std::min<std::size_t>( chunks, threads ) );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// for_each_chunk
+//////////////////////////////////////////////////////////////////////////
+// calls f(chunk, begin, end) for `chunks` contiguous slices of [0, n)
+// the caller takes part, returns once all chunks are done
+template< typename F >
+void for_each_chunk( std::size_t n, std::size_t chunks, F&& f, thread_pool& pool = thread_pool::shared() ) {
+    auto bounds = [n, chunks]( std::size_t i ) { return n / chunks * i + std::min( i, n % chunks ); };
+    pool.run( chunks, [&f, &bounds]( std::size_t i ) { f( i, bounds( i ), bounds( i + 1 ) ); } );
+}
+
+} // namespace perf
+
+#endif  // PERF_PARALLEL_HPP
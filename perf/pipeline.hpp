@@ -0,0 +1,221 @@
+//  perf/pipeline.hpp  -------------------------------------------------------//
+
+//  Lazy filter/transform pipelines fused into a single pass.
+//
+//      auto odd_squares = perf::from( values ) | perf::reject( is_even ) | perf::transform( square );
+//      std::vector<int> out = odd_squares.to_vector();   // the only pass over values
+//
+//      // the erase-remove chain from auto_modern.cpp, one pass instead of two
+//      perf::in_place( values, perf::reject( is_even ) | perf::reject( is_odd ) );
+//
+//  Nothing runs until a terminal operation (for_each, to_vector, count,
+//  in_place). Each element is then pushed through every stage in turn, the
+//  stages are inlined into one loop, and no intermediate buffer is allocated.
+//
+//  Lifetime requirements: a view refers to its source range, the range must
+//  outlive the view.
+
+#ifndef PERF_PIPELINE_HPP
+#define PERF_PIPELINE_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace perf {
+
+//////////////////////////////////////////////////////////////////////////
+// Stages
+//////////////////////////////////////////////////////////////////////////
+// a stage receives one element and passes zero or one elements to next
+template< typename Pred >
+struct filter_stage {
+    Pred pred;
+
+    template< typename T >
+    using output = T;
+
+    template< typename T, typename Next >
+    void push( T&& x, Next&& next ) const {
+        if ( pred( x ) ) {
+            next( std::forward<T>( x ) );
+        }
+    }
+};
+
+template< typename Pred >
+struct reject_stage {
+    Pred pred;
+
+    template< typename T >
+    using output = T;
+
+    template< typename T, typename Next >
+    void push( T&& x, Next&& next ) const {
+        if ( !pred( x ) ) {
+            next( std::forward<T>( x ) );
+        }
+    }
+};
+
+template< typename F >
+struct transform_stage {
+    F f;
+
+    template< typename T >
+    using output = std::decay_t<std::invoke_result_t<const F&, T>>;
+
+    template< typename T, typename Next >
+    void push( T&& x, Next&& next ) const {
+        next( f( std::forward<T>( x ) ) );
+    }
+};
+
+//////////////////////////////////////////////////////////////////////////
+// pipeline
+//////////////////////////////////////////////////////////////////////////
+template< typename... Stages >
+struct pipeline {
+    std::tuple<Stages...> stages;
+
+    // push x through every stage, survivors reach sink
+    template< typename T, typename Sink >
+    void push( T&& x, Sink& sink ) const {
+        push_from<0>( std::forward<T>( x ), sink );
+    }
+
+private:
+    template< std::size_t I, typename T, typename Sink >
+    void push_from( T&& x, Sink& sink ) const {
+        if constexpr ( I == sizeof...( Stages ) ) {
+            sink( std::forward<T>( x ) );
+        } else {
+            std::get<I>( stages ).push( std::forward<T>( x ),
+                                        [this, &sink]( auto&& y ) { push_from<I + 1>( std::forward<decltype( y )>( y ), sink ); } );
+        }
+    }
+};
+
+namespace detail {
+
+template< typename T, typename... Stages >
+struct pipeline_output { using type = T; };
+
+template< typename T, typename Stage, typename... Rest >
+struct pipeline_output<T, Stage, Rest...> {
+    using type = typename pipeline_output<typename Stage::template output<T>, Rest...>::type;
+};
+
+} // namespace detail
+
+// the element type that comes out of a pipeline fed with T
+template< typename Pipeline, typename T >
+struct pipeline_output;
+
+template< typename... Stages, typename T >
+struct pipeline_output<pipeline<Stages...>, T> : detail::pipeline_output<T, Stages...> {};
+
+template< typename... A, typename... B >
+pipeline<A..., B...> operator|( pipeline<A...> lhs, pipeline<B...> rhs ) {
+    return { std::tuple_cat( std::move( lhs.stages ), std::move( rhs.stages ) ) };
+}
+
+template< typename Pred >
+pipeline<filter_stage<Pred>> filter( Pred pred ) { return { { { std::move( pred ) } } }; }
+
+// keeps what remove_if would keep
+template< typename Pred >
+pipeline<reject_stage<Pred>> reject( Pred pred ) { return { { { std::move( pred ) } } }; }
+
+template< typename F >
+pipeline<transform_stage<F>> transform( F f ) { return { { { std::move( f ) } } }; }
+
+//////////////////////////////////////////////////////////////////////////
+// view
+//////////////////////////////////////////////////////////////////////////
+// a source range plus the stages to apply, evaluated only by the terminal operations
+template< typename Range, typename Pipeline >
+class view {
+public:
+    using source_type = std::remove_reference_t<decltype( *std::begin( std::declval<Range&>() ) )>;
+    // filter and reject pass elements through by reference, to_vector stores values
+    using value_type = std::decay_t<typename pipeline_output<Pipeline, source_type&>::type>;
+
+    view( Range& range, Pipeline p ) : m_range( range ), m_pipeline( std::move( p ) ) {}
+
+    template< typename... Stages >
+    friend auto operator|( view v, pipeline<Stages...> more ) {
+        auto combined = std::move( v.m_pipeline ) | std::move( more );
+        return view<Range, decltype( combined )>( v.m_range, std::move( combined ) );
+    }
+
+    template< typename F >
+    void for_each( F f ) const {
+        for ( auto& x : m_range ) {
+            m_pipeline.push( x, f );
+        }
+    }
+
+    std::size_t count() const {
+        std::size_t n = 0;
+        auto sink = [&n]( auto&& ) { ++n; };
+        for ( auto& x : m_range ) {
+            m_pipeline.push( x, sink );
+        }
+        return n;
+    }
+
+    template< typename OutputIt >
+    OutputIt copy_to( OutputIt out ) const {
+        auto sink = [&out]( auto&& y ) { *out++ = std::forward<decltype( y )>( y ); };
+        for ( auto& x : m_range ) {
+            m_pipeline.push( x, sink );
+        }
+        return out;
+    }
+
+    std::vector<value_type> to_vector() const {
+        std::vector<value_type> out;
+        copy_to( std::back_inserter( out ) );
+        return out;
+    }
+
+private:
+    Range& m_range;
+    Pipeline m_pipeline;
+};
+
+template< typename Range >
+view<Range, pipeline<>> from( Range& range ) { return { range, {} }; }
+
+//////////////////////////////////////////////////////////////////////////
+// in_place
+//////////////////////////////////////////////////////////////////////////
+// runs the pipeline over the container and keeps only its output, like a chain of
+// erase-remove passes fused into one; transforms must keep the element type
+template< typename Container, typename... Stages >
+std::size_t in_place( Container& c, const pipeline<Stages...>& p ) {
+    auto out = c.begin();
+    auto sink = [&out]( auto&& y ) {
+        using T = std::decay_t<decltype( y )>;
+        // an element that survives unchanged may be moved onto itself
+        if ( std::is_trivially_copyable<T>::value || std::addressof( *out ) != std::addressof( y ) ) {
+            *out = std::forward<decltype( y )>( y );
+        }
+        ++out;
+    };
+    // out never overtakes the element being read, every stage emits at most one element
+    for ( auto it = c.begin(); it != c.end(); ++it ) {
+        p.push( std::move( *it ), sink );
+    }
+    c.erase( out, c.end() );
+    return c.size();
+}
+
+} // namespace perf
+
+#endif  // PERF_PIPELINE_HPP
@@ -0,0 +1,224 @@
+//  perf/profiled_mutex.hpp  -------------------------------------------------//
+
+//  A mutex wrapper that measures how contended it is.
+//
+//      static perf::lock_site widget_cache_site{ "Widget::m_cached_mutex" };
+//      mutable perf::profiled_mutex<> m_cached_mutex{ widget_cache_site };
+//      ...
+//      std::lock_guard<perf::profiled_mutex<>> _{ m_cached_mutex };   // unchanged call sites
+//      ...
+//      perf::print_lock_report();   // worst offenders by total time spent waiting
+//
+//  Every acquisition first tries the lock. When that succeeds, and most do,
+//  the only extra work is bumping two counters that live next to the mutex,
+//  under the lock. Only when try_lock fails is the acquisition counted as
+//  contended and the wait timed. Measured by profiled_mutex_modern.cpp with
+//  glibc, an uncontended lock + unlock costs about 17 ns against 8 ns for
+//  std::mutex; all but 2 ns or so of that is pthread_mutex_trylock being
+//  slower than pthread_mutex_lock.
+//
+//  Hold times are sampled: one acquisition in lock_site::sample_interval()
+//  (64 by default) reads the TSC on lock and unlock and records into the
+//  thread's histogram. Passing 1 times every hold, which costs about 70 ns per
+//  lock + unlock, mostly the two TSC reads. Acquisition counts reach the site
+//  in batches, at every sample, every contended lock and when the mutex is
+//  destroyed, so a report taken while mutexes are alive can miss up to
+//  sample_interval() - 1 acquisitions per mutex.
+//
+//  Statistics are kept per lock_site rather than per mutex, so a mutex
+//  embedded in every Widget costs no more memory than the mutex itself plus
+//  a pointer, and the report shows "Widget::m_cached_mutex" once with the
+//  totals across all widgets. Sites must outlive every thread that locks
+//  them, make them statics.
+
+#ifndef PERF_PROFILED_MUTEX_HPP
+#define PERF_PROFILED_MUTEX_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+#include "tsc_clock.hpp"
+
+namespace perf {
+
+//////////////////////////////////////////////////////////////////////////
+// lock_site
+//////////////////////////////////////////////////////////////////////////
+class lock_site {
+public:
+    explicit lock_site( const char* name, std::uint32_t sample_interval = 64 )
+        : m_name( name ), m_sample_interval( sample_interval == 0 ? 1 : sample_interval ) {
+        std::lock_guard<std::mutex> _{ registry_mutex() };
+        registry().push_back( this );
+    }
+    lock_site( const lock_site& ) = delete;
+    lock_site& operator=( const lock_site& ) = delete;
+
+    const char* name() const noexcept { return m_name; }
+    // one acquisition in this many has its hold time recorded
+    std::uint32_t sample_interval() const noexcept { return m_sample_interval; }
+
+    // every acquisition, as flushed by the mutexes so far
+    std::uint64_t acquisitions() const noexcept { return m_acquisitions.load( std::memory_order_relaxed ); }
+    void add_acquisitions( std::uint64_t n ) noexcept { m_acquisitions.fetch_add( n, std::memory_order_relaxed ); }
+
+    // in ticks, one sample per contended acquisition
+    thread_histograms& wait() noexcept { return m_wait; }
+    const thread_histograms& wait() const noexcept { return m_wait; }
+    // in ticks, one sample per sample_interval() acquisitions
+    thread_histograms& hold() noexcept { return m_hold; }
+    const thread_histograms& hold() const noexcept { return m_hold; }
+
+    static std::vector<lock_site*> all() {
+        std::lock_guard<std::mutex> _{ registry_mutex() };
+        return registry();
+    }
+
+    // for mutexes constructed without a site
+    static lock_site& unnamed() {
+        static lock_site site{ "<unnamed>" };
+        return site;
+    }
+
+private:
+    static std::vector<lock_site*>& registry() {
+        static std::vector<lock_site*> sites;
+        return sites;
+    }
+    static std::mutex& registry_mutex() {
+        static std::mutex m;
+        return m;
+    }
+
+    const char* m_name;
+    std::uint32_t m_sample_interval;
+    std::atomic<std::uint64_t> m_acquisitions{ 0 };
+    thread_histograms m_wait;
+    thread_histograms m_hold;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// profiled_mutex
+//////////////////////////////////////////////////////////////////////////
+// meets the Lockable requirements of the wrapped mutex
+template< typename Mutex = std::mutex >
+class profiled_mutex {
+public:
+    profiled_mutex() : m_site( &lock_site::unnamed() ) {}
+    explicit profiled_mutex( lock_site& site ) noexcept : m_site( &site ) {}
+    profiled_mutex( const profiled_mutex& ) = delete;
+    profiled_mutex& operator=( const profiled_mutex& ) = delete;
+    ~profiled_mutex() { flush(); }
+
+    void lock() {
+        if ( !m_mutex.try_lock() ) {
+            std::uint64_t start = tsc_clock::ticks();
+            m_mutex.lock();
+            std::uint64_t waited = tsc_clock::ticks() - start;
+            acquired();
+            // already slow, flushing here keeps the contended share accurate
+            flush();
+            m_site->wait().local().record( waited );
+            return;
+        }
+        acquired();
+    }
+
+    bool try_lock() {
+        if ( !m_mutex.try_lock() ) {
+            return false;
+        }
+        acquired();
+        return true;
+    }
+
+    void unlock() {
+        if ( m_sampled_at == 0 ) {
+            m_mutex.unlock();
+            return;
+        }
+        std::uint64_t held = tsc_clock::ticks() - m_sampled_at;
+        m_sampled_at = 0;
+        std::uint32_t count = m_unflushed;
+        m_unflushed = 0;
+        m_mutex.unlock();
+        m_site->add_acquisitions( count );
+        m_site->hold().local().record( held );
+    }
+
+    lock_site& site() const noexcept { return *m_site; }
+
+private:
+    // the members below are only touched while holding the lock
+    void acquired() noexcept {
+        ++m_unflushed;
+        if ( --m_until_sample == 0 ) {
+            m_until_sample = m_site->sample_interval();
+            m_sampled_at = tsc_clock::ticks();
+        }
+    }
+
+    void flush() noexcept {
+        if ( m_unflushed != 0 ) {
+            m_site->add_acquisitions( m_unflushed );
+            m_unflushed = 0;
+        }
+    }
+
+    Mutex m_mutex;
+    lock_site* m_site;
+    // nonzero while a sampled acquisition holds the lock
+    std::uint64_t m_sampled_at = 0;
+    std::uint32_t m_unflushed = 0;
+    // the first acquisition is sampled, so even a rarely used mutex shows up in the report
+    std::uint32_t m_until_sample = 1;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Report
+//////////////////////////////////////////////////////////////////////////
+struct lock_stats {
+    const char* name;
+    std::uint64_t acquired;
+    log_histogram wait;
+    log_histogram hold;
+
+    std::uint64_t acquisitions() const noexcept { return acquired; }
+    std::uint64_t contended() const noexcept { return wait.count(); }
+};
+
+// every site with at least one acquisition, most total wait time first
+inline std::vector<lock_stats> lock_report() {
+    std::vector<lock_stats> stats;
+    for ( auto* site : lock_site::all() ) {
+        lock_stats s{ site->name(), site->acquisitions(), site->wait().merged(), site->hold().merged() };
+        if ( s.acquisitions() > 0 ) {
+            stats.push_back( s );
+        }
+    }
+    std::sort( stats.begin(), stats.end(), []( const lock_stats& a, const lock_stats& b ) { return a.wait.sum() > b.wait.sum(); } );
+    return stats;
+}
+
+inline void print_lock_report( std::size_t worst = 10, std::FILE* out = stdout ) {
+    auto ns = []( std::uint64_t ticks ) { return static_cast<double>( tsc_clock::to_duration( ticks ).count() ); };
+    std::fprintf( out, "%-28s %10s %9s %12s %10s %10s %10s %10s\n", "lock", "acquired", "contended", "wait total",
+                  "wait p50", "wait p99", "hold p50", "hold p99" );
+    auto stats = lock_report();
+    for ( std::size_t i = 0; i < stats.size() && i < worst; ++i ) {
+        const auto& s = stats[i];
+        std::fprintf( out, "%-28s %10llu %8.2f%% %9.3f ms %7.0f ns %7.0f ns %7.0f ns %7.0f ns\n", s.name,
+                      static_cast<unsigned long long>( s.acquisitions() ),
+                      100.0 * static_cast<double>( s.contended() ) / static_cast<double>( s.acquisitions() ),
+                      ns( s.wait.sum() ) / 1e6, ns( s.wait.percentile( 0.5 ) ), ns( s.wait.percentile( 0.99 ) ),
+                      ns( s.hold.percentile( 0.5 ) ), ns( s.hold.percentile( 0.99 ) ) );
+    }
+}
+
+} // namespace perf
+
+#endif  // PERF_PROFILED_MUTEX_HPP
@@ -0,0 +1,455 @@
+//  perf/radix_sort.hpp  -----------------------------------------------------//
+
+//  Radix sorts for types ordered by an integer or floating point key.
+//
+//  RegularWidget (class_modern.cpp) compares by its ordinal and nothing else.
+//  std::sort needs O(n log n) of those comparisons, and their branches
+//  mispredict about half the time on shuffled input. A radix sort reads the
+//  key one byte at a time and moves every element once per byte:
+//
+//      perf::radix_sort( widgets.begin(), widgets.end(),
+//                        []( const RegularWidget& w ) { return w.ordinal(); } );
+//
+//  The key is anything std::invoke accepts: a lambda, a member pointer or a
+//  member function pointer, though a pointer may end up called indirectly
+//  where a lambda is always inlined. Without a key the elements are the keys.
+//  The order is the same as operator< on the keys. For floating point, -0.0
+//  sorts before 0.0, and NaNs go to the front or back depending on their sign.
+//
+//  radix_sort          MSD, in place (American flag sort), not stable
+//  stable_radix_sort   one MSD pass into a buffer of n elements, then LSD
+//                      within each bucket while it is in cache, stable
+//
+//  Key bytes that are the same for every element are skipped, so ordinals
+//  that fit in 20 bits cost three passes, not four. Pass perf::parallel as the
+//  first argument to sort large ranges on a thread_pool.
+
+#ifndef PERF_RADIX_SORT_HPP
+#define PERF_RADIX_SORT_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "parallel.hpp"
+#include "uninitialized.hpp"
+
+namespace perf {
+
+namespace detail {
+
+//////////////////////////////////////////////////////////////////////////
+// Keys as unsigned integers
+//////////////////////////////////////////////////////////////////////////
+// maps a key to an unsigned integer with the same order
+template< typename K >
+auto radix_bits( K k ) noexcept {
+    static_assert( std::is_arithmetic<K>::value || std::is_enum<K>::value, "radix sort keys must be numbers or enums" );
+    static_assert( !std::is_same<K, bool>::value, "radix sort keys must not be bool" );
+    if constexpr ( std::is_enum<K>::value ) {
+        return radix_bits( static_cast<std::underlying_type_t<K>>( k ) );
+    } else if constexpr ( std::is_floating_point<K>::value ) {
+        static_assert( sizeof( K ) == 4 || sizeof( K ) == 8, "float and double keys only" );
+        using U = std::conditional_t<sizeof( K ) == 4, std::uint32_t, std::uint64_t>;
+        U u;
+        std::memcpy( &u, &k, sizeof( u ) );
+        // negatives: flip everything so larger magnitudes sort first; positives: set the sign bit
+        constexpr U sign = U( 1 ) << ( sizeof( U ) * 8 - 1 );
+        return ( u & sign ) ? U( ~u ) : U( u | sign );
+    } else if constexpr ( std::is_signed<K>::value ) {
+        using U = std::make_unsigned_t<K>;
+        return U( U( k ) ^ ( U( 1 ) << ( sizeof( U ) * 8 - 1 ) ) );
+    } else {
+        return k;
+    }
+}
+
+struct identity_key {
+    template< typename T >
+    const T& operator()( const T& x ) const noexcept {
+        return x;
+    }
+};
+
+template< typename It, typename Key >
+struct radix_traits {
+    using value_type = typename std::iterator_traits<It>::value_type;
+    using bits_type = decltype( radix_bits( std::invoke( std::declval<Key&>(), std::declval<const value_type&>() ) ) );
+    static constexpr int digits = sizeof( bits_type );
+};
+
+constexpr std::size_t radix_buckets = 256;
+using radix_histogram = std::array<std::size_t, radix_buckets>;
+
+// below this a comparison sort on the key is faster than a pass
+constexpr std::size_t radix_small = 128;
+// per thread, smaller ranges are sorted on one thread
+constexpr std::size_t radix_min_chunk = std::size_t{ 1 } << 16;
+
+inline std::size_t radix_digit( std::uint64_t bits, int shift ) noexcept {
+    return static_cast<std::size_t>( ( bits >> shift ) & 0xff );
+}
+
+inline bool single_bucket( const radix_histogram& count, std::size_t n ) noexcept {
+    return std::any_of( count.begin(), count.end(), [n]( std::size_t c ) { return c == n; } );
+}
+
+template< typename It, typename Bits >
+void small_sort( It first, It last, Bits& bits ) {
+    std::sort( first, last, [&bits]( const auto& a, const auto& b ) { return bits( a ) < bits( b ); } );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// MSD, in place
+//////////////////////////////////////////////////////////////////////////
+// moves every element into its bucket for the byte at shift, count becomes the bucket ends
+template< typename It, typename Bits >
+void partition_by_digit( It first, radix_histogram& count, int shift, Bits& bits ) {
+    radix_histogram head;
+    std::size_t sum = 0;
+    for ( std::size_t b = 0; b < radix_buckets; ++b ) {
+        head[b] = sum;
+        sum += count[b];
+        count[b] = sum;
+    }
+    for ( std::size_t b = 0; b < radix_buckets; ++b ) {
+        // swap each misplaced element straight into the bucket it belongs to
+        while ( head[b] < count[b] ) {
+            std::size_t d = radix_digit( bits( first[head[b]] ), shift );
+            if ( d == b ) {
+                ++head[b];
+            } else {
+                using std::swap;
+                swap( first[head[b]], first[head[d]++] );
+            }
+        }
+    }
+}
+
+// the highest byte at or below shift that is not the same for every element, -1 if none
+// count holds its histogram
+template< typename It, typename Bits >
+int first_varying_digit( It first, std::size_t n, int shift, radix_histogram& count, Bits& bits ) {
+    for ( ; shift >= 0; shift -= 8 ) {
+        count.fill( 0 );
+        for ( std::size_t i = 0; i < n; ++i ) {
+            ++count[radix_digit( bits( first[i] ), shift )];
+        }
+        if ( !single_bucket( count, n ) ) {
+            break;
+        }
+    }
+    return shift;
+}
+
+template< typename It, typename Bits >
+void msd_sort( It first, std::size_t n, int shift, Bits& bits ) {
+    if ( n <= radix_small ) {
+        small_sort( first, first + n, bits );
+        return;
+    }
+    radix_histogram count;
+    shift = first_varying_digit( first, n, shift, count, bits );
+    if ( shift < 0 ) {
+        return;
+    }
+    partition_by_digit( first, count, shift, bits );
+    if ( shift == 0 ) {
+        return;
+    }
+    std::size_t begin = 0;
+    for ( std::size_t b = 0; b < radix_buckets; ++b ) {
+        msd_sort( first + begin, count[b] - begin, shift - 8, bits );
+        begin = count[b];
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// LSD, through a buffer
+//////////////////////////////////////////////////////////////////////////
+// n uninitialized elements, constructed by the first pass that scatters into it
+template< typename T >
+class radix_buffer {
+    static_assert( std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_assignable<T>::value,
+                   "stable_radix_sort moves elements through a buffer and cannot recover from a throwing move" );
+
+public:
+    explicit radix_buffer( std::size_t n ) : m_data( std::allocator<T>().allocate( n ) ), m_size( n ) {}
+    radix_buffer( const radix_buffer& ) = delete;
+    radix_buffer& operator=( const radix_buffer& ) = delete;
+    ~radix_buffer() {
+        if ( m_constructed ) {
+            destroy_n( m_data, m_size );
+        }
+        std::allocator<T>().deallocate( m_data, m_size );
+    }
+
+    T* data() const noexcept { return m_data; }
+    void set_constructed() noexcept { m_constructed = true; }
+
+private:
+    T* m_data;
+    std::size_t m_size;
+    bool m_constructed = false;
+};
+
+// moves src[begin, end) to dst at offset[digit], bumping the offset
+template< bool Construct, typename Src, typename Dst, typename Bits >
+void scatter( Src src, std::size_t begin, std::size_t end, Dst dst, std::size_t* offset, int shift, Bits& bits ) {
+    for ( std::size_t i = begin; i < end; ++i ) {
+        auto& x = src[i];
+        std::size_t& o = offset[radix_digit( bits( x ), shift )];
+        if constexpr ( Construct ) {
+            using T = std::remove_reference_t<decltype( x )>;
+            ::new ( static_cast<void*>( std::addressof( dst[o] ) ) ) T( std::move( x ) );
+        } else {
+            dst[o] = std::move( x );
+        }
+        ++o;
+    }
+}
+
+constexpr int radix_max_digits = 8;
+using radix_histograms = std::array<radix_histogram, radix_max_digits>;
+
+// histograms of every key byte of src[begin, end), one read for all of them
+template< int Digits, typename Src, typename Bits >
+void count_digits( Src src, std::size_t begin, std::size_t end, radix_histograms& count, Bits& bits ) {
+    for ( int d = 0; d < Digits; ++d ) {
+        count[d].fill( 0 );
+    }
+    for ( std::size_t i = begin; i < end; ++i ) {
+        auto k = bits( src[i] );
+        for ( int d = 0; d < Digits; ++d ) {
+            ++count[d][radix_digit( k, 8 * d )];
+        }
+    }
+}
+
+// count becomes the bucket starts, returns the total
+inline std::size_t exclusive_prefix( radix_histogram& count ) noexcept {
+    std::size_t sum = 0;
+    for ( auto& c : count ) {
+        std::size_t size = c;
+        c = sum;
+        sum += size;
+    }
+    return sum;
+}
+
+// the elements are in buffer[0, n) and end up sorted by their low `digits` bytes in first[0, n)
+// a bucket of the top pass is small enough to stay in cache for all of its passes
+template< int Digits, typename T, typename It, typename Bits >
+void lsd_bucket( T* buffer, It first, std::size_t n, int digits, Bits& bits ) {
+    if ( digits > 0 && n <= radix_small ) {
+        std::stable_sort( buffer, buffer + n, [&bits]( const T& a, const T& b ) { return bits( a ) < bits( b ); } );
+        digits = 0;
+    }
+    radix_histograms count;
+    if ( digits > 0 ) {
+        count_digits<Digits>( buffer, 0, n, count, bits );
+    }
+    bool in_buffer = true;
+    for ( int d = 0; d < digits; ++d ) {
+        if ( single_bucket( count[d], n ) ) {
+            continue;
+        }
+        exclusive_prefix( count[d] );
+        if ( in_buffer ) {
+            scatter<false>( buffer, 0, n, first, count[d].data(), 8 * d, bits );
+        } else {
+            scatter<false>( first, 0, n, buffer, count[d].data(), 8 * d, bits );
+        }
+        in_buffer = !in_buffer;
+    }
+    if ( in_buffer ) {
+        std::move( buffer, buffer + n, first );
+    }
+}
+
+// the highest byte that is not the same for all n elements, -1 if none
+inline int top_digit( const radix_histograms& count, int digits, std::size_t n ) noexcept {
+    int top = digits - 1;
+    while ( top >= 0 && single_bucket( count[top], n ) ) {
+        --top;
+    }
+    return top;
+}
+
+// one stable pass on the highest varying byte into the buffer, then LSD within each bucket
+template< int Digits, typename It, typename Bits >
+void lsd_sort( It first, std::size_t n, Bits& bits ) {
+    using T = typename std::iterator_traits<It>::value_type;
+    radix_histograms count;
+    count_digits<Digits>( first, 0, n, count, bits );
+    int top = top_digit( count, Digits, n );
+    if ( top < 0 ) {
+        return;
+    }
+    radix_buffer<T> buffer( n );
+    exclusive_prefix( count[top] );
+    scatter<true>( first, 0, n, buffer.data(), count[top].data(), 8 * top, bits );
+    buffer.set_constructed();
+    // the offsets have advanced to the bucket ends
+    std::size_t begin = 0;
+    for ( std::size_t end : count[top] ) {
+        lsd_bucket<Digits>( buffer.data() + begin, first + begin, end - begin, top, bits );
+        begin = end;
+    }
+}
+
+// the top pass histograms and scatters one chunk per thread, then the buckets are sorted concurrently
+template< int Digits, typename It, typename Bits >
+void parallel_lsd_sort( thread_pool& pool, It first, std::size_t n, Bits& bits ) {
+    using T = typename std::iterator_traits<It>::value_type;
+    std::size_t chunks = chunk_count( n, radix_min_chunk, pool.concurrency() );
+    if ( chunks == 1 ) {
+        lsd_sort<Digits>( first, n, bits );
+        return;
+    }
+    std::vector<radix_histograms> count( chunks );
+    for_each_chunk( n, chunks, [&]( std::size_t c, std::size_t b, std::size_t e ) {
+        count_digits<Digits>( first, b, e, count[c], bits );
+    }, pool );
+    radix_histograms total{};
+    for ( std::size_t c = 0; c < chunks; ++c ) {
+        for ( int d = 0; d < Digits; ++d ) {
+            for ( std::size_t b = 0; b < radix_buckets; ++b ) {
+                total[d][b] += count[c][d][b];
+            }
+        }
+    }
+    int top = top_digit( total, Digits, n );
+    if ( top < 0 ) {
+        return;
+    }
+    // bucket by bucket, chunk by chunk, so each chunk keeps its order within a bucket
+    std::size_t sum = 0;
+    for ( std::size_t b = 0; b < radix_buckets; ++b ) {
+        for ( std::size_t c = 0; c < chunks; ++c ) {
+            std::size_t size = count[c][top][b];
+            count[c][top][b] = sum;
+            sum += size;
+        }
+    }
+    radix_buffer<T> buffer( n );
+    for_each_chunk( n, chunks, [&]( std::size_t c, std::size_t b, std::size_t e ) {
+        scatter<true>( first, b, e, buffer.data(), count[c][top].data(), 8 * top, bits );
+    }, pool );
+    buffer.set_constructed();
+    // the last chunk's offsets have advanced to the bucket ends
+    const radix_histogram& end = count[chunks - 1][top];
+    pool.run( radix_buckets, [&]( std::size_t b ) {
+        std::size_t begin = b == 0 ? 0 : end[b - 1];
+        lsd_bucket<Digits>( buffer.data() + begin, first + begin, end[b] - begin, top, bits );
+    } );
+}
+
+// Calling a pointer to member function has a branch for virtual functions that
+// reads a vtable pointer out of the object. For a class without virtual
+// functions that branch is never taken, but GCC still flags the read as out of
+// bounds when the object is smaller than a pointer, such as the one-int
+// RegularWidget keyed by &RegularWidget::ordinal: a false positive.
+#if defined( __GNUC__ ) && !defined( __clang__ )
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Warray-bounds"
+#endif
+template< typename It, typename Key >
+auto make_bits( Key& key ) {
+    using T = typename std::iterator_traits<It>::value_type;
+    return [&key]( const T& x ) { return radix_bits( std::invoke( key, x ) ); };
+}
+#if defined( __GNUC__ ) && !defined( __clang__ )
+#pragma GCC diagnostic pop
+#endif
+
+template< typename It >
+constexpr bool is_radix_sortable = std::is_base_of<std::random_access_iterator_tag,
+                                                   typename std::iterator_traits<It>::iterator_category>::value;
+
+} // namespace detail
+
+//////////////////////////////////////////////////////////////////////////
+// radix_sort
+//////////////////////////////////////////////////////////////////////////
+// sorts [first, last) by key( x ) in place, equal keys end up in any order
+template< typename RandomIt, typename Key = detail::identity_key >
+void radix_sort( RandomIt first, RandomIt last, Key key = {} ) {
+    static_assert( detail::is_radix_sortable<RandomIt>, "radix_sort needs random access iterators" );
+    using traits = detail::radix_traits<RandomIt, Key>;
+    auto bits = detail::make_bits<RandomIt>( key );
+    detail::msd_sort( first, static_cast<std::size_t>( last - first ), 8 * ( traits::digits - 1 ), bits );
+}
+
+// splits on the highest byte that differs, then sorts the buckets concurrently
+template< typename RandomIt, typename Key = detail::identity_key >
+void radix_sort( parallel_t policy, RandomIt first, RandomIt last, Key key = {} ) {
+    static_assert( detail::is_radix_sortable<RandomIt>, "radix_sort needs random access iterators" );
+    using traits = detail::radix_traits<RandomIt, Key>;
+    auto bits = detail::make_bits<RandomIt>( key );
+    auto n = static_cast<std::size_t>( last - first );
+    thread_pool& pool = policy.pool();
+    int shift = 8 * ( traits::digits - 1 );
+    if ( chunk_count( n, detail::radix_min_chunk, pool.concurrency() ) == 1 ) {
+        detail::msd_sort( first, n, shift, bits );
+        return;
+    }
+    detail::radix_histogram count;
+    shift = detail::first_varying_digit( first, n, shift, count, bits );
+    if ( shift < 0 ) {
+        return;
+    }
+    detail::partition_by_digit( first, count, shift, bits );
+    if ( shift == 0 ) {
+        return;
+    }
+    pool.run( detail::radix_buckets, [&]( std::size_t b ) {
+        std::size_t begin = b == 0 ? 0 : count[b - 1];
+        detail::msd_sort( first + begin, count[b] - begin, shift - 8, bits );
+    } );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// stable_radix_sort
+//////////////////////////////////////////////////////////////////////////
+// sorts [first, last) by key( x ), equal keys keep their order
+template< typename RandomIt, typename Key = detail::identity_key >
+void stable_radix_sort( RandomIt first, RandomIt last, Key key = {} ) {
+    static_assert( detail::is_radix_sortable<RandomIt>, "stable_radix_sort needs random access iterators" );
+    using traits = detail::radix_traits<RandomIt, Key>;
+    auto bits = detail::make_bits<RandomIt>( key );
+    auto n = static_cast<std::size_t>( last - first );
+    if ( n <= detail::radix_small ) {
+        std::stable_sort( first, last, [&bits]( const auto& a, const auto& b ) { return bits( a ) < bits( b ); } );
+        return;
+    }
+    detail::lsd_sort<traits::digits>( first, n, bits );
+}
+
+// the top pass histograms and scatters one chunk per thread, then each bucket finishes
+// its lower digits with LSD passes on its own thread
+template< typename RandomIt, typename Key = detail::identity_key >
+void stable_radix_sort( parallel_t policy, RandomIt first, RandomIt last, Key key = {} ) {
+    static_assert( detail::is_radix_sortable<RandomIt>, "stable_radix_sort needs random access iterators" );
+    using traits = detail::radix_traits<RandomIt, Key>;
+    auto bits = detail::make_bits<RandomIt>( key );
+    auto n = static_cast<std::size_t>( last - first );
+    if ( n <= detail::radix_small ) {
+        std::stable_sort( first, last, [&bits]( const auto& a, const auto& b ) { return bits( a ) < bits( b ); } );
+        return;
+    }
+    detail::parallel_lsd_sort<traits::digits>( policy.pool(), first, n, bits );
+}
+
+} // namespace perf
+
+#endif  // PERF_RADIX_SORT_HPP
@@ -0,0 +1,175 @@
+//  perf/recycling_allocator.hpp  --------------------------------------------//
+
+//  An allocator that keeps freed blocks on a thread-local freelist.
+//
+//  Returning a std::vector by value (parameter_modern.cpp) is the right
+//  interface, but a function called in a loop then allocates and frees the
+//  same large block every time. Large blocks come straight from mmap, so each
+//  call also page faults the whole buffer in again. The out-parameter style
+//  (parameter_classic.cpp) avoids that by making the caller keep the buffer.
+//
+//  With recycling_allocator the vector keeps its value semantics and the
+//  buffer is recycled anyway: destroying a vector puts its block on the
+//  freelist of the destroying thread, the next allocation of the same size
+//  class on that thread takes it back without calling malloc.
+//
+//      perf::recycled_vector<int> heavy_result_type() {
+//          perf::recycled_vector<int> results;
+//          results.resize( 100'000 );
+//          return results;
+//      }
+//
+//  Blocks are rounded up to a power of two of at least 64 bytes. Each thread
+//  keeps at most max_cached_blocks per size class; the rest go back to the
+//  heap. The allocator is stateless, a block may be freed on another thread.
+
+#ifndef PERF_RECYCLING_ALLOCATOR_HPP
+#define PERF_RECYCLING_ALLOCATOR_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <vector>
+
+#include "simd.hpp"
+
+namespace perf {
+
+struct recycling_stats {
+    std::uint64_t hits = 0;     // allocations served from the freelist
+    std::uint64_t misses = 0;   // allocations that went to operator new
+};
+
+namespace detail {
+
+class block_cache {
+public:
+    static constexpr int min_class = 6;         // 64 bytes, room for the freelist link
+    static constexpr int class_count = 48;
+    static constexpr std::size_t max_cached_blocks = 8;
+
+    block_cache() { alive() = true; }
+    block_cache( const block_cache& ) = delete;
+    block_cache& operator=( const block_cache& ) = delete;
+    ~block_cache() {
+        trim();
+        alive() = false;
+    }
+
+    void* allocate( std::size_t bytes ) {
+        int c = size_class( bytes );
+        if ( free_block* b = m_free[c] ) {
+            m_free[c] = b->next;
+            --m_cached[c];
+            ++m_stats.hits;
+            return b;
+        }
+        ++m_stats.misses;
+        return ::operator new( std::size_t{ 1 } << c );
+    }
+
+    void deallocate( void* p, std::size_t bytes ) noexcept {
+        int c = size_class( bytes );
+        if ( m_cached[c] == max_cached_blocks ) {
+            ::operator delete( p );
+            return;
+        }
+        m_free[c] = ::new ( p ) free_block{ m_free[c] };
+        ++m_cached[c];
+    }
+
+    // give every cached block back to the heap
+    void trim() noexcept {
+        for ( int c = 0; c < class_count; ++c ) {
+            while ( free_block* b = m_free[c] ) {
+                m_free[c] = b->next;
+                ::operator delete( b );
+            }
+            m_cached[c] = 0;
+        }
+    }
+
+    const recycling_stats& stats() const noexcept { return m_stats; }
+
+    static int size_class( std::size_t bytes ) noexcept {
+        if ( bytes <= ( std::size_t{ 1 } << min_class ) ) {
+            return min_class;
+        }
+        return 64 - count_leading_zeros( static_cast<std::uint64_t>( bytes - 1 ) );
+    }
+
+    // thread_local destructors run before some statics are destroyed, a trivially
+    // destructible flag tells late deallocations to bypass the cache
+    static bool& alive() noexcept {
+        thread_local bool flag = false;
+        return flag;
+    }
+
+private:
+    struct free_block {
+        free_block* next;
+    };
+
+    std::array<free_block*, class_count> m_free{};
+    std::array<std::size_t, class_count> m_cached{};
+    recycling_stats m_stats;
+};
+
+inline block_cache& thread_block_cache() {
+    thread_local block_cache cache;
+    return cache;
+}
+
+} // namespace detail
+
+//////////////////////////////////////////////////////////////////////////
+// recycling_allocator
+//////////////////////////////////////////////////////////////////////////
+template< typename T >
+class recycling_allocator {
+    static_assert( alignof( T ) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "over-aligned types are not supported" );
+
+public:
+    using value_type = T;
+
+    recycling_allocator() noexcept = default;
+    template< typename U >
+    recycling_allocator( const recycling_allocator<U>& ) noexcept {}
+
+    T* allocate( std::size_t n ) {
+        if ( n > max_elements ) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>( detail::thread_block_cache().allocate( n * sizeof( T ) ) );
+    }
+
+    void deallocate( T* p, std::size_t n ) noexcept {
+        if ( detail::block_cache::alive() ) {
+            detail::thread_block_cache().deallocate( p, n * sizeof( T ) );
+        } else {
+            ::operator delete( p );
+        }
+    }
+
+    friend bool operator==( const recycling_allocator&, const recycling_allocator& ) noexcept { return true; }
+    friend bool operator!=( const recycling_allocator&, const recycling_allocator& ) noexcept { return false; }
+
+private:
+    static constexpr std::size_t max_elements =
+        ( std::size_t{ 1 } << ( detail::block_cache::class_count - 1 ) ) / sizeof( T );
+};
+
+template< typename T >
+using recycled_vector = std::vector<T, recycling_allocator<T>>;
+
+// this thread's freelist hit/miss counts
+inline recycling_stats thread_recycling_stats() { return detail::thread_block_cache().stats(); }
+
+// return this thread's cached blocks to the heap, e.g. after a burst
+inline void trim_recycling_cache() { detail::thread_block_cache().trim(); }
+
+} // namespace perf
+
+#endif  // PERF_RECYCLING_ALLOCATOR_HPP
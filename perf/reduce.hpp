@@ -0,0 +1,384 @@
+//  perf/reduce.hpp  ---------------------------------------------------------//
+
+//  Reductions over contiguous ranges: sum, sum_wide, min/max and count.
+//
+//  Every function is constexpr. At compile time it runs a plain loop, so
+//  results can still be used as template arguments, e.g. std::array<int, sum(a)>.
+//  At run time 32-bit integer ranges use AVX2 kernels when available, other
+//  element types use the scalar loop (which the compiler is free to vectorize).
+//
+//  sum     result has the element type, integers wrap on overflow like the SIMD lanes do
+//  sum_wide accumulates into 64 bits (or double), use it when the total may overflow
+//
+//  Pass perf::parallel as the first argument to split very large ranges across threads.
+
+#ifndef PERF_REDUCE_HPP
+#define PERF_REDUCE_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+namespace perf {
+
+//////////////////////////////////////////////////////////////////////////
+// Result types
+//////////////////////////////////////////////////////////////////////////
+template< typename T, typename = void >
+struct wide { using type = T; };
+
+template< typename T >
+struct wide<T, std::enable_if_t<std::is_integral<T>::value && std::is_signed<T>::value>> { using type = std::int64_t; };
+
+template< typename T >
+struct wide<T, std::enable_if_t<std::is_integral<T>::value && std::is_unsigned<T>::value>> { using type = std::uint64_t; };
+
+template<>
+struct wide<float> { using type = double; };
+
+template< typename T >
+using wide_t = typename wide<T>::type;
+
+template< typename T >
+struct minmax_result {
+    T min;
+    T max;
+};
+
+namespace detail {
+
+// below this many elements per thread perf::parallel runs sequentially
+constexpr std::size_t reduce_min_chunk = std::size_t{ 1 } << 18;
+
+template< typename T >
+constexpr bool is_int32 = std::is_integral<T>::value && sizeof( T ) == 4;
+
+//////////////////////////////////////////////////////////////////////////
+// Scalar kernels
+//////////////////////////////////////////////////////////////////////////
+template< typename T >
+constexpr T sum_scalar( const T* first, const T* last ) {
+    if constexpr ( std::is_integral<T>::value ) {
+        // unsigned arithmetic wraps instead of invoking undefined behaviour
+        using U = std::make_unsigned_t<T>;
+        U total = 0;
+        for ( ; first != last; ++first ) {
+            total += static_cast<U>( *first );
+        }
+        return static_cast<T>( total );
+    } else {
+        T total = 0;
+        for ( ; first != last; ++first ) {
+            total += *first;
+        }
+        return total;
+    }
+}
+
+template< typename T >
+constexpr wide_t<T> sum_wide_scalar( const T* first, const T* last ) {
+    wide_t<T> total = 0;
+    for ( ; first != last; ++first ) {
+        total += *first;
+    }
+    return total;
+}
+
+template< typename T >
+constexpr minmax_result<T> minmax_scalar( const T* first, const T* last ) {
+    minmax_result<T> r{ *first, *first };
+    for ( ++first; first != last; ++first ) {
+        // conditional moves, not branches
+        r.min = *first < r.min ? *first : r.min;
+        r.max = r.max < *first ? *first : r.max;
+    }
+    return r;
+}
+
+template< typename T >
+constexpr std::ptrdiff_t count_scalar( const T* first, const T* last, const T& value ) {
+    std::ptrdiff_t n = 0;
+    for ( ; first != last; ++first ) {
+        n += *first == value;
+    }
+    return n;
+}
+
+#if PERF_AVX2
+//////////////////////////////////////////////////////////////////////////
+// AVX2 kernels
+//////////////////////////////////////////////////////////////////////////
+// four independent accumulators hide the latency of the vector adds
+inline std::uint32_t sum_avx2( const std::uint32_t* p, std::size_t n ) {
+    __m256i a0 = _mm256_setzero_si256(), a1 = a0, a2 = a0, a3 = a0;
+    std::size_t i = 0;
+    for ( ; i + 32 <= n; i += 32 ) {
+        a0 = _mm256_add_epi32( a0, _mm256_loadu_si256( reinterpret_cast<const __m256i*>( p + i ) ) );
+        a1 = _mm256_add_epi32( a1, _mm256_loadu_si256( reinterpret_cast<const __m256i*>( p + i + 8 ) ) );
+        a2 = _mm256_add_epi32( a2, _mm256_loadu_si256( reinterpret_cast<const __m256i*>( p + i + 16 ) ) );
+        a3 = _mm256_add_epi32( a3, _mm256_loadu_si256( reinterpret_cast<const __m256i*>( p + i + 24 ) ) );
+    }
+    for ( ; i + 8 <= n; i += 8 ) {
+        a0 = _mm256_add_epi32( a0, _mm256_loadu_si256( reinterpret_cast<const __m256i*>( p + i ) ) );
+    }
+    __m256i a = _mm256_add_epi32( _mm256_add_epi32( a0, a1 ), _mm256_add_epi32( a2, a3 ) );
+    auto total = static_cast<std::uint32_t>( hsum_epi32( a ) );
+    return total + sum_scalar( p + i, p + n );
+}
+
+template< bool Signed >
+inline __m256i widen_lo( __m256i v ) {
+    return Signed ? _mm256_cvtepi32_epi64( _mm256_castsi256_si128( v ) )
+                  : _mm256_cvtepu32_epi64( _mm256_castsi256_si128( v ) );
+}
+
+template< bool Signed >
+inline __m256i widen_hi( __m256i v ) {
+    return Signed ? _mm256_cvtepi32_epi64( _mm256_extracti128_si256( v, 1 ) )
+                  : _mm256_cvtepu32_epi64( _mm256_extracti128_si256( v, 1 ) );
+}
+
+template< typename T >
+inline wide_t<T> sum_wide_avx2( const T* p, std::size_t n ) {
+    constexpr bool is_signed = std::is_signed<T>::value;
+    __m256i a0 = _mm256_setzero_si256(), a1 = a0, a2 = a0, a3 = a0;
+    std::size_t i = 0;
+    for ( ; i + 16 <= n; i += 16 ) {
+        __m256i v0 = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( p + i ) );
+        __m256i v1 = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( p + i + 8 ) );
+        a0 = _mm256_add_epi64( a0, widen_lo<is_signed>( v0 ) );
+        a1 = _mm256_add_epi64( a1, widen_hi<is_signed>( v0 ) );
+        a2 = _mm256_add_epi64( a2, widen_lo<is_signed>( v1 ) );
+        a3 = _mm256_add_epi64( a3, widen_hi<is_signed>( v1 ) );
+    }
+    __m256i a = _mm256_add_epi64( _mm256_add_epi64( a0, a1 ), _mm256_add_epi64( a2, a3 ) );
+    auto total = static_cast<wide_t<T>>( hsum_epi64( a ) );
+    return total + sum_wide_scalar( p + i, p + n );
+}
+
+// n must be at least 1
+inline minmax_result<std::int32_t> minmax_avx2( const std::int32_t* p, std::size_t n ) {
+    if ( n < 8 ) {
+        return minmax_scalar( p, p + n );
+    }
+    __m256i lo = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( p ) );
+    __m256i hi = lo;
+    std::size_t i = 8;
+    for ( ; i + 8 <= n; i += 8 ) {
+        __m256i v = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( p + i ) );
+        lo = _mm256_min_epi32( lo, v );
+        hi = _mm256_max_epi32( hi, v );
+    }
+    // finish with one overlapping load instead of a scalar tail
+    __m256i v = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( p + n - 8 ) );
+    lo = _mm256_min_epi32( lo, v );
+    hi = _mm256_max_epi32( hi, v );
+    return { hmin_epi32( lo ), hmax_epi32( hi ) };
+}
+
+inline std::ptrdiff_t count_avx2( const std::uint32_t* p, std::size_t n, std::uint32_t value ) {
+    const __m256i needle = _mm256_set1_epi32( static_cast<int>( value ) );
+    std::ptrdiff_t total = 0;
+    std::size_t i = 0;
+    while ( i + 8 <= n ) {
+        // equal lanes are -1, subtracting counts them; flush before a lane could overflow
+        __m256i c = _mm256_setzero_si256();
+        std::size_t block_end = std::min( n, i + ( std::size_t{ 1 } << 30 ) );
+        for ( ; i + 8 <= block_end; i += 8 ) {
+            __m256i v = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( p + i ) );
+            c = _mm256_sub_epi32( c, _mm256_cmpeq_epi32( v, needle ) );
+        }
+        total += static_cast<std::uint32_t>( hsum_epi32( c ) );
+    }
+    return total + count_scalar( p + i, p + n, value );
+}
+#endif
+
+} // namespace detail
+
+//////////////////////////////////////////////////////////////////////////
+// sum
+//////////////////////////////////////////////////////////////////////////
+template< typename T >
+constexpr T sum( const T* first, const T* last ) {
+#if PERF_AVX2
+    if constexpr ( detail::is_int32<T> ) {
+        if ( !is_constant_evaluated() ) {
+            auto p = reinterpret_cast<const std::uint32_t*>( first );
+            return static_cast<T>( detail::sum_avx2( p, static_cast<std::size_t>( last - first ) ) );
+        }
+    }
+#endif
+    return detail::sum_scalar( first, last );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// sum_wide
+//////////////////////////////////////////////////////////////////////////
+// overflow-safe for every 8, 16 and 32-bit integer range that fits in memory
+template< typename T >
+constexpr wide_t<T> sum_wide( const T* first, const T* last ) {
+#if PERF_AVX2
+    if constexpr ( detail::is_int32<T> ) {
+        if ( !is_constant_evaluated() ) {
+            return detail::sum_wide_avx2( first, static_cast<std::size_t>( last - first ) );
+        }
+    }
+#endif
+    return detail::sum_wide_scalar( first, last );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// min_value / max_value / minmax_value
+//////////////////////////////////////////////////////////////////////////
+// precondition: the range is not empty
+template< typename T >
+constexpr minmax_result<T> minmax_value( const T* first, const T* last ) {
+    assert( first != last );
+#if PERF_AVX2
+    if constexpr ( std::is_same<T, std::int32_t>::value ) {
+        if ( !is_constant_evaluated() ) {
+            return detail::minmax_avx2( first, static_cast<std::size_t>( last - first ) );
+        }
+    }
+#endif
+    return detail::minmax_scalar( first, last );
+}
+
+template< typename T >
+constexpr T min_value( const T* first, const T* last ) {
+    return minmax_value( first, last ).min;
+}
+
+template< typename T >
+constexpr T max_value( const T* first, const T* last ) {
+    return minmax_value( first, last ).max;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// count
+//////////////////////////////////////////////////////////////////////////
+template< typename T >
+constexpr std::ptrdiff_t count( const T* first, const T* last, const T& value ) {
+#if PERF_AVX2
+    if constexpr ( detail::is_int32<T> ) {
+        if ( !is_constant_evaluated() ) {
+            auto p = reinterpret_cast<const std::uint32_t*>( first );
+            return detail::count_avx2( p, static_cast<std::size_t>( last - first ), static_cast<std::uint32_t>( value ) );
+        }
+    }
+#endif
+    return detail::count_scalar( first, last, value );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Multithreaded mode
+//////////////////////////////////////////////////////////////////////////
+namespace detail {
+
+template< typename T, typename R, typename Reduce, typename Combine >
+R parallel_reduce( parallel_t policy, const T* first, const T* last, Reduce reduce, Combine combine ) {
+    auto n = static_cast<std::size_t>( last - first );
+    thread_pool& pool = policy.pool();
+    std::size_t chunks = chunk_count( n, reduce_min_chunk, pool.concurrency() );
+    if ( chunks == 1 ) {
+        return reduce( first, last );
+    }
+    std::vector<R> partial( chunks );
+    for_each_chunk( n, chunks, [&]( std::size_t i, std::size_t b, std::size_t e ) {
+        partial[i] = reduce( first + b, first + e );
+    }, pool );
+    R result = partial[0];
+    for ( std::size_t i = 1; i < chunks; ++i ) {
+        result = combine( result, partial[i] );
+    }
+    return result;
+}
+
+} // namespace detail
+
+template< typename T >
+T sum( parallel_t policy, const T* first, const T* last ) {
+    return detail::parallel_reduce<T, T>( policy, first, last,
+        []( const T* f, const T* l ) { return sum( f, l ); },
+        []( T a, T b ) {
+            const T both[] = { a, b };
+            return detail::sum_scalar( both, both + 2 );
+        } );
+}
+
+template< typename T >
+wide_t<T> sum_wide( parallel_t policy, const T* first, const T* last ) {
+    return detail::parallel_reduce<T, wide_t<T>>( policy, first, last,
+        []( const T* f, const T* l ) { return sum_wide( f, l ); },
+        []( wide_t<T> a, wide_t<T> b ) { return a + b; } );
+}
+
+template< typename T >
+minmax_result<T> minmax_value( parallel_t policy, const T* first, const T* last ) {
+    assert( first != last );
+    return detail::parallel_reduce<T, minmax_result<T>>( policy, first, last,
+        []( const T* f, const T* l ) { return minmax_value( f, l ); },
+        []( minmax_result<T> a, minmax_result<T> b ) {
+            return minmax_result<T>{ b.min < a.min ? b.min : a.min, a.max < b.max ? b.max : a.max };
+        } );
+}
+
+template< typename T >
+T min_value( parallel_t policy, const T* first, const T* last ) {
+    return minmax_value( policy, first, last ).min;
+}
+
+template< typename T >
+T max_value( parallel_t policy, const T* first, const T* last ) {
+    return minmax_value( policy, first, last ).max;
+}
+
+template< typename T >
+std::ptrdiff_t count( parallel_t policy, const T* first, const T* last, const T& value ) {
+    return detail::parallel_reduce<T, std::ptrdiff_t>( policy, first, last,
+        [&value]( const T* f, const T* l ) { return count( f, l, value ); },
+        []( std::ptrdiff_t a, std::ptrdiff_t b ) { return a + b; } );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Range overloads
+//////////////////////////////////////////////////////////////////////////
+// any contiguous range with std::data and std::size: std::array, std::vector, C arrays
+#define PERF_REDUCE_RANGE_OVERLOAD( name )                                                                  \
+    template< typename Range >                                                                              \
+    constexpr auto name( const Range& r ) -> decltype( name( std::data( r ), std::data( r ) + std::size( r ) ) ) { \
+        return name( std::data( r ), std::data( r ) + std::size( r ) );                                     \
+    }                                                                                                       \
+    template< typename Range >                                                                              \
+    auto name( parallel_t p, const Range& r ) -> decltype( name( p, std::data( r ), std::data( r ) + std::size( r ) ) ) { \
+        return name( p, std::data( r ), std::data( r ) + std::size( r ) );                                  \
+    }
+
+PERF_REDUCE_RANGE_OVERLOAD( sum )
+PERF_REDUCE_RANGE_OVERLOAD( sum_wide )
+PERF_REDUCE_RANGE_OVERLOAD( minmax_value )
+PERF_REDUCE_RANGE_OVERLOAD( min_value )
+PERF_REDUCE_RANGE_OVERLOAD( max_value )
+#undef PERF_REDUCE_RANGE_OVERLOAD
+
+template< typename Range, typename T >
+constexpr auto count( const Range& r, const T& value ) -> decltype( count( std::data( r ), std::data( r ) + std::size( r ), value ) ) {
+    return count( std::data( r ), std::data( r ) + std::size( r ), value );
+}
+
+template< typename Range, typename T >
+auto count( parallel_t p, const Range& r, const T& value ) -> decltype( count( p, std::data( r ), std::data( r ) + std::size( r ), value ) ) {
+    return count( p, std::data( r ), std::data( r ) + std::size( r ), value );
+}
+
+} // namespace perf
+
+#endif  // PERF_REDUCE_HPP
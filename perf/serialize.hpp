@@ -0,0 +1,242 @@
+//  perf/serialize.hpp  ------------------------------------------------------//
+
+//  Binary encode/decode generated at compile time from a list of fields.
+//
+//  Describe a struct once by listing pointers to its members, in declaration order
+//  (see perf/fields.hpp):
+//
+//      struct Order { std::int64_t id; double price; std::int32_t qty; std::int32_t side; };
+//      template<> struct perf::field_list<Order> : perf::fields<&Order::id, &Order::price,
+//                                                               &Order::qty, &Order::side> {};
+//
+//  and encode/decode/encoded_size work for it, for nested described structs,
+//  and for std::string and std::vector members.
+//
+//  Wire format: fields in list order, no padding, host byte order.
+//  - trivially copyable fields are their raw bytes
+//  - std::string and std::vector are a uint32 element count followed by the elements
+//  - when every field is trivially copyable and the fields cover every byte of the
+//    struct, the wire format is identical to the memory layout and a struct (or an
+//    array of them with encode_n) is written with a single memcpy
+//
+//  decode does no bounds checking, validate the buffer size before decoding untrusted data.
+
+#ifndef PERF_SERIALIZE_HPP
+#define PERF_SERIALIZE_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "fields.hpp"
+
+namespace perf {
+
+namespace detail {
+
+template< typename T, typename = void >
+struct codec;
+
+template< typename T, typename Fields = decltype( as_fields( field_list<T>{} ) ) >
+struct record_codec;
+
+//////////////////////////////////////////////////////////////////////////
+// Raw fields
+//////////////////////////////////////////////////////////////////////////
+template< typename T >
+struct raw_codec {
+    static constexpr bool fixed = true;
+    static constexpr bool bulk = true;
+    static constexpr std::size_t size = sizeof( T );
+
+    static std::size_t encoded_size( const T& ) { return size; }
+    static std::byte* encode( const T& v, std::byte* out ) {
+        std::memcpy( out, &v, size );
+        return out + size;
+    }
+    static const std::byte* decode( const std::byte* in, T& v ) {
+        std::memcpy( &v, in, size );
+        return in + size;
+    }
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Sequences
+//////////////////////////////////////////////////////////////////////////
+template< typename Sequence, typename Element >
+struct sequence_codec {
+    static constexpr bool fixed = false;
+    static constexpr bool bulk = false;
+    static constexpr std::size_t size = 0;
+
+    static std::size_t encoded_size( const Sequence& s ) {
+        std::size_t n = sizeof( std::uint32_t );
+        if constexpr ( codec<Element>::fixed ) {
+            n += s.size() * codec<Element>::size;
+        } else {
+            for ( const auto& e : s ) {
+                n += codec<Element>::encoded_size( e );
+            }
+        }
+        return n;
+    }
+    static std::byte* encode( const Sequence& s, std::byte* out ) {
+        auto count = static_cast<std::uint32_t>( s.size() );
+        out = raw_codec<std::uint32_t>::encode( count, out );
+        return encode_elements( s.data(), s.size(), out );
+    }
+    static const std::byte* decode( const std::byte* in, Sequence& s ) {
+        std::uint32_t count;
+        in = raw_codec<std::uint32_t>::decode( in, count );
+        s.resize( count );
+        return decode_elements( in, s.size(), s.data() );
+    }
+
+    static std::byte* encode_elements( const Element* p, std::size_t n, std::byte* out ) {
+        if constexpr ( codec<Element>::bulk ) {
+            if ( n != 0 ) {
+                std::memcpy( out, p, n * sizeof( Element ) );
+            }
+            return out + n * sizeof( Element );
+        } else {
+            for ( std::size_t i = 0; i < n; ++i ) {
+                out = codec<Element>::encode( p[i], out );
+            }
+            return out;
+        }
+    }
+    static const std::byte* decode_elements( const std::byte* in, std::size_t n, Element* p ) {
+        if constexpr ( codec<Element>::bulk ) {
+            if ( n != 0 ) {
+                std::memcpy( static_cast<void*>( p ), in, n * sizeof( Element ) );
+            }
+            return in + n * sizeof( Element );
+        } else {
+            for ( std::size_t i = 0; i < n; ++i ) {
+                in = codec<Element>::decode( in, p[i] );
+            }
+            return in;
+        }
+    }
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Described records
+//////////////////////////////////////////////////////////////////////////
+template< typename T, auto... Members >
+struct record_codec<T, fields<Members...>> {
+    static constexpr bool fixed = ( codec<member_t<Members>>::fixed && ... );
+    static constexpr std::size_t size = fixed ? ( std::size_t{ 0 } + ... + codec<member_t<Members>>::size ) : 0;
+    // the fields tile the whole object, so its bytes already are the wire format
+    static constexpr bool bulk = ( codec<member_t<Members>>::bulk && ... ) &&
+                                 std::is_trivially_copyable<T>::value && size == sizeof( T );
+
+    static std::size_t encoded_size( const T& v ) {
+        if constexpr ( fixed ) {
+            return size;
+        } else {
+            return ( std::size_t{ 0 } + ... + codec<member_t<Members>>::encoded_size( v.*Members ) );
+        }
+    }
+    static std::byte* encode( const T& v, std::byte* out ) {
+        if constexpr ( bulk ) {
+            assert( declared_in_order( v ) );
+            std::memcpy( out, &v, sizeof( T ) );
+            return out + sizeof( T );
+        } else {
+            // one constant-size copy per field, the same pack expansion as for_each_argument
+            ( ( out = codec<member_t<Members>>::encode( v.*Members, out ) ), ... );
+            return out;
+        }
+    }
+    static const std::byte* decode( const std::byte* in, T& v ) {
+        if constexpr ( bulk ) {
+            std::memcpy( static_cast<void*>( &v ), in, sizeof( T ) );
+            return in + sizeof( T );
+        } else {
+            ( ( in = codec<member_t<Members>>::decode( in, v.*Members ) ), ... );
+            return in;
+        }
+    }
+
+    // the bulk path relies on the field list following the declaration order
+    static bool declared_in_order( const T& v ) {
+        const char* addresses[] = { reinterpret_cast<const char*>( &( v.*Members ) )... };
+        for ( std::size_t i = 1; i < sizeof...( Members ); ++i ) {
+            if ( !( addresses[i - 1] < addresses[i] ) ) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Codec selection
+//////////////////////////////////////////////////////////////////////////
+template< typename T, typename >
+struct codec : raw_codec<T> {
+    static_assert( std::is_trivially_copyable<T>::value,
+                   "give this type a perf::field_list or make it trivially copyable" );
+};
+
+template< typename T >
+struct codec<T, std::enable_if_t<has_field_list<T>::value>> : record_codec<T> {};
+
+template< typename Char >
+struct codec<std::basic_string<Char>> : sequence_codec<std::basic_string<Char>, Char> {};
+
+template< typename Element >
+struct codec<std::vector<Element>> : sequence_codec<std::vector<Element>, Element> {};
+
+} // namespace detail
+
+//////////////////////////////////////////////////////////////////////////
+// Interface
+//////////////////////////////////////////////////////////////////////////
+template< typename T >
+constexpr bool is_fixed_size_v = detail::codec<T>::fixed;
+
+// wire size of a fixed size type
+template< typename T >
+constexpr std::size_t fixed_size_v = detail::codec<T>::size;
+
+// true when encoding is a plain memcpy of the object
+template< typename T >
+constexpr bool is_bulk_serializable_v = detail::codec<T>::bulk;
+
+template< typename T >
+std::size_t encoded_size( const T& v ) {
+    return detail::codec<T>::encoded_size( v );
+}
+
+// returns one past the last byte written
+template< typename T >
+std::byte* encode( const T& v, std::byte* out ) {
+    return detail::codec<T>::encode( v, out );
+}
+
+// returns one past the last byte read
+template< typename T >
+const std::byte* decode( const std::byte* in, T& v ) {
+    return detail::codec<T>::decode( in, v );
+}
+
+// arrays of records, a single memcpy for bulk serializable types
+template< typename T >
+std::byte* encode_n( const T* p, std::size_t n, std::byte* out ) {
+    return detail::sequence_codec<std::vector<T>, T>::encode_elements( p, n, out );
+}
+
+template< typename T >
+const std::byte* decode_n( const std::byte* in, std::size_t n, T* p ) {
+    return detail::sequence_codec<std::vector<T>, T>::decode_elements( in, n, p );
+}
+
+} // namespace perf
+
+#endif  // PERF_SERIALIZE_HPP
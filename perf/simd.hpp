@@ -0,0 +1,145 @@
+//  perf/simd.hpp  -----------------------------------------------------------//
+
+//  Small portability layer shared by the vectorized perf headers.
+//
+//  PERF_AVX2 is 1 when the translation unit is compiled with AVX2 enabled
+//  (-mavx2 or /arch:AVX2, see the MODERNCPP_AVX2 CMake option). Every kernel
+//  guarded by it has a scalar fallback, so the headers build everywhere.
+//  PERF_SSE2 is 1 wherever SSE2 is available, which is every x86-64 target.
+
+#ifndef PERF_SIMD_HPP
+#define PERF_SIMD_HPP
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(__AVX2__)
+#define PERF_AVX2 1
+#include <immintrin.h>
+#else
+#define PERF_AVX2 0
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#define PERF_SSE2 1
+#include <emmintrin.h>
+#else
+#define PERF_SSE2 0
+#endif
+
+namespace perf {
+
+//////////////////////////////////////////////////////////////////////////
+// is_constant_evaluated
+//////////////////////////////////////////////////////////////////////////
+// C++20 std::is_constant_evaluated, available as a builtin on all compilers we care about.
+// lets one constexpr function pick a plain loop at compile time and SIMD at run time
+constexpr bool is_constant_evaluated() noexcept {
+#if defined(__GNUC__) || defined(__clang__) || ( defined(_MSC_VER) && _MSC_VER >= 1925 )
+    return __builtin_is_constant_evaluated();
+#else
+    return false;
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Bit helpers
+//////////////////////////////////////////////////////////////////////////
+inline int count_trailing_zeros( std::uint32_t x ) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long i;
+    _BitScanForward( &i, x );
+    return static_cast<int>( i );
+#else
+    return __builtin_ctz( x );
+#endif
+}
+
+inline int count_trailing_zeros( std::uint64_t x ) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long i;
+    _BitScanForward64( &i, x );
+    return static_cast<int>( i );
+#else
+    return __builtin_ctzll( x );
+#endif
+}
+
+inline int count_leading_zeros( std::uint64_t x ) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long i;
+    _BitScanReverse64( &i, x );
+    return 63 - static_cast<int>( i );
+#else
+    return __builtin_clzll( x );
+#endif
+}
+
+inline int popcount( std::uint32_t x ) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return static_cast<int>( __popcnt( x ) );
+#else
+    return __builtin_popcount( x );
+#endif
+}
+
+// hint the cache, a no-op where unsupported
+inline void prefetch( const void* p ) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch( p );
+#elif defined(_MSC_VER) && ( defined(_M_X64) || defined(_M_IX86) )
+    _mm_prefetch( static_cast<const char*>( p ), _MM_HINT_T0 );
+#else
+    (void)p;
+#endif
+}
+
+// spin-wait hint, lets the sibling hyperthread run and avoids the memory-order flush on exit
+inline void cpu_relax() noexcept {
+#if ( defined(__GNUC__) || defined(__clang__) ) && ( defined(__x86_64__) || defined(__i386__) )
+    __builtin_ia32_pause();
+#elif defined(_MSC_VER) && ( defined(_M_X64) || defined(_M_IX86) )
+    _mm_pause();
+#elif ( defined(__GNUC__) || defined(__clang__) ) && defined(__aarch64__)
+    asm volatile( "yield" );
+#endif
+}
+
+#if PERF_AVX2
+//////////////////////////////////////////////////////////////////////////
+// Horizontal reductions
+//////////////////////////////////////////////////////////////////////////
+inline std::int32_t hsum_epi32( __m256i v ) noexcept {
+    __m128i x = _mm_add_epi32( _mm256_castsi256_si128( v ), _mm256_extracti128_si256( v, 1 ) );
+    x = _mm_add_epi32( x, _mm_shuffle_epi32( x, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+    x = _mm_add_epi32( x, _mm_shuffle_epi32( x, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+    return _mm_cvtsi128_si32( x );
+}
+
+inline std::int64_t hsum_epi64( __m256i v ) noexcept {
+    __m128i x = _mm_add_epi64( _mm256_castsi256_si128( v ), _mm256_extracti128_si256( v, 1 ) );
+    x = _mm_add_epi64( x, _mm_unpackhi_epi64( x, x ) );
+    return _mm_cvtsi128_si64( x );
+}
+
+inline std::int32_t hmin_epi32( __m256i v ) noexcept {
+    __m128i x = _mm_min_epi32( _mm256_castsi256_si128( v ), _mm256_extracti128_si256( v, 1 ) );
+    x = _mm_min_epi32( x, _mm_shuffle_epi32( x, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+    x = _mm_min_epi32( x, _mm_shuffle_epi32( x, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+    return _mm_cvtsi128_si32( x );
+}
+
+inline std::int32_t hmax_epi32( __m256i v ) noexcept {
+    __m128i x = _mm_max_epi32( _mm256_castsi256_si128( v ), _mm256_extracti128_si256( v, 1 ) );
+    x = _mm_max_epi32( x, _mm_shuffle_epi32( x, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+    x = _mm_max_epi32( x, _mm_shuffle_epi32( x, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+    return _mm_cvtsi128_si32( x );
+}
+#endif
+
+} // namespace perf
+
+#endif  // PERF_SIMD_HPP
@@ -0,0 +1,126 @@
+//  perf/small_lock.hpp  -----------------------------------------------------//
+
+//  Locks that don't cost 40 bytes per object.
+//
+//  std::mutex is 40 bytes on Linux (pthread_mutex_t), ten times the int it
+//  usually guards in the cached-value pattern. Two ways out:
+//
+//  byte_lock           a one byte spin lock, embed it like a mutex. Good when
+//                      critical sections are short (filling a cache) and
+//                      holders don't block; waiters spin, then yield.
+//
+//  striped_lock_table  no per-object storage at all: objects hash their
+//                      address to one of N shared, cache-line padded mutexes.
+//                      Unrelated objects occasionally share a stripe, so never
+//                      hold a stripe while locking another object through
+//                      the same table.
+//
+//      std::lock_guard<perf::byte_lock> _{ m_lock };
+//      std::lock_guard<std::mutex> _{ perf::shared_lock_table().for_address( this ) };
+
+#ifndef PERF_SMALL_LOCK_HPP
+#define PERF_SMALL_LOCK_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "simd.hpp"
+
+namespace perf {
+
+//////////////////////////////////////////////////////////////////////////
+// byte_lock
+//////////////////////////////////////////////////////////////////////////
+class byte_lock {
+public:
+    byte_lock() = default;
+    byte_lock( const byte_lock& ) = delete;
+    byte_lock& operator=( const byte_lock& ) = delete;
+
+    void lock() noexcept {
+        if ( !m_locked.exchange( true, std::memory_order_acquire ) ) {
+            return;
+        }
+        lock_slow();
+    }
+
+    bool try_lock() noexcept {
+        return !m_locked.load( std::memory_order_relaxed ) && !m_locked.exchange( true, std::memory_order_acquire );
+    }
+
+    void unlock() noexcept { m_locked.store( false, std::memory_order_release ); }
+
+private:
+    // spin on a plain load so waiters share the line instead of bouncing it with exchanges
+    void lock_slow() noexcept {
+        for ( int spins = 0;; ) {
+            while ( m_locked.load( std::memory_order_relaxed ) ) {
+                if ( ++spins < 128 ) {
+                    cpu_relax();
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            if ( !m_locked.exchange( true, std::memory_order_acquire ) ) {
+                return;
+            }
+        }
+    }
+
+    std::atomic<bool> m_locked{ false };
+};
+
+static_assert( sizeof( byte_lock ) == 1, "byte_lock should fit in a byte of padding" );
+
+//////////////////////////////////////////////////////////////////////////
+// striped_lock_table
+//////////////////////////////////////////////////////////////////////////
+template< typename Mutex = std::mutex, std::size_t Stripes = 256 >
+class striped_lock_table {
+    static_assert( Stripes > 0 && ( Stripes & ( Stripes - 1 ) ) == 0, "Stripes must be a power of two" );
+
+public:
+    // the same address always maps to the same mutex
+    Mutex& for_address( const void* p ) noexcept {
+        auto x = static_cast<std::uint64_t>( reinterpret_cast<std::uintptr_t>( p ) );
+        if constexpr ( Stripes == 1 ) {
+            return m_stripes[0].mutex;
+        } else {
+            // fibonacci hashing, the top bits mix every bit of the address
+            x *= 0x9E3779B97F4A7C15ull;
+            return m_stripes[static_cast<std::size_t>( x >> ( 64 - stripe_bits() ) )].mutex;
+        }
+    }
+
+    static constexpr std::size_t stripes() noexcept { return Stripes; }
+
+private:
+    static constexpr unsigned stripe_bits() noexcept {
+        unsigned bits = 0;
+        while ( ( std::size_t{ 1 } << bits ) < Stripes ) {
+            ++bits;
+        }
+        return bits;
+    }
+
+    // one mutex per cache line, or neighbouring stripes contend anyway
+    struct alignas( 64 ) stripe {
+        Mutex mutex;
+    };
+
+    std::array<stripe, Stripes> m_stripes;
+};
+
+// process-wide table for objects that don't need their own
+inline striped_lock_table<>& shared_lock_table() {
+    static striped_lock_table<> table;
+    return table;
+}
+
+} // namespace perf
+
+#endif  // PERF_SMALL_LOCK_HPP
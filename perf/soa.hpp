@@ -0,0 +1,445 @@
+//  perf/soa.hpp  ------------------------------------------------------------//
+
+//  A structure-of-arrays container for record types described with
+//  perf::field_list (see perf/fields.hpp).
+//
+//  std::vector<Shape> keeps whole records side by side, so a loop that reads
+//  only shape.type still pulls every other field through the cache. In a
+//  soa_vector<Shape> each listed field has its own contiguous column:
+//
+//      template<> struct perf::field_list<Shape> : perf::fields<&Shape::type, &Shape::x, &Shape::y> {};
+//
+//      perf::soa_vector<Shape> shapes;
+//      shapes.push_back( Shape{ SHAPE_CIRCLE, 1.0f, 2.0f } );
+//      auto types = shapes.column<&Shape::type>();      // column_span<ShapeType>
+//      auto circles = std::count( types.begin(), types.end(), SHAPE_CIRCLE );
+//      shapes[0].get<&Shape::x>() = 3.0f;               // one field through the proxy
+//      Shape first = shapes[0];                         // the whole record, gathered
+//
+//  Columns live in one allocation and each starts on a 64 byte boundary, so
+//  SIMD loops over a column_span can use aligned loads from element 0.
+//
+//  Elements are proxies, like std::vector<bool>: operator[] and the iterators
+//  return references that gather into a T or scatter a T on assignment.
+//  Gathering a record needs T to be default constructible; fields not in the
+//  list are not stored. Field types need a noexcept move constructor unless
+//  they are trivially relocatable.
+
+#ifndef PERF_SOA_HPP
+#define PERF_SOA_HPP
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "fields.hpp"
+#include "uninitialized.hpp"
+
+namespace perf {
+
+// every column starts on a cache line
+constexpr std::size_t soa_alignment = 64;
+
+//////////////////////////////////////////////////////////////////////////
+// column_span
+//////////////////////////////////////////////////////////////////////////
+// one column of a soa_vector, contiguous and aligned to soa_alignment
+template< typename F >
+class column_span {
+public:
+    using element_type = F;
+    using value_type = std::remove_cv_t<F>;
+    using size_type = std::size_t;
+    using iterator = F*;
+
+    static constexpr std::size_t alignment = soa_alignment;
+
+    constexpr column_span() noexcept = default;
+    constexpr column_span( F* data, size_type size ) noexcept : m_data( data ), m_size( size ) {}
+
+    constexpr F* data() const noexcept { return m_data; }
+    constexpr size_type size() const noexcept { return m_size; }
+    constexpr bool empty() const noexcept { return m_size == 0; }
+    constexpr F* begin() const noexcept { return m_data; }
+    constexpr F* end() const noexcept { return m_data + m_size; }
+    constexpr F& operator[]( size_type i ) const noexcept { assert( i < m_size ); return m_data[i]; }
+
+private:
+    F* m_data = nullptr;
+    size_type m_size = 0;
+};
+
+namespace detail {
+
+template< auto Member >
+struct member_constant {};
+
+// position of Member in Members..., sizeof...( Members ) when absent
+template< auto Member, auto... Members >
+constexpr std::size_t index_of_member() {
+    constexpr bool match[] = { std::is_same<member_constant<Member>, member_constant<Members>>::value... };
+    for ( std::size_t i = 0; i < sizeof...( Members ); ++i ) {
+        if ( match[i] ) {
+            return i;
+        }
+    }
+    return sizeof...( Members );
+}
+
+constexpr std::size_t align_up( std::size_t n, std::size_t alignment ) {
+    return ( n + alignment - 1 ) & ~( alignment - 1 );
+}
+
+} // namespace detail
+
+//////////////////////////////////////////////////////////////////////////
+// soa_vector
+//////////////////////////////////////////////////////////////////////////
+template< typename T, typename Fields = decltype( detail::as_fields( field_list<T>{} ) ) >
+class soa_vector;
+
+template< typename T, auto... Members >
+class soa_vector<T, fields<Members...>> {
+    static constexpr std::size_t field_count = sizeof...( Members );
+    static_assert( field_count > 0, "list at least one field in perf::field_list" );
+    static_assert( ( ( alignof( detail::member_t<Members> ) <= soa_alignment ) && ... ),
+                   "fields aligned beyond soa_alignment are not supported" );
+
+    template< std::size_t I >
+    using field_at = std::tuple_element_t<I, std::tuple<detail::member_t<Members>...>>;
+
+    template< auto Member >
+    static constexpr std::size_t index_of() {
+        constexpr std::size_t i = detail::index_of_member<Member, Members...>();
+        static_assert( i < field_count, "the member is not in this type's perf::field_list" );
+        return i;
+    }
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    //////////////////////////////////////////////////////////////////////////
+    // Element proxy
+    //////////////////////////////////////////////////////////////////////////
+    // refers to element i, every access goes to the columns
+    template< bool Const >
+    class basic_reference {
+        using vector_type = std::conditional_t<Const, const soa_vector, soa_vector>;
+
+    public:
+        basic_reference( vector_type& v, size_type i ) noexcept : m_vector( &v ), m_index( i ) {}
+        basic_reference( const basic_reference& ) = default;
+
+        // one field, by pointer to member
+        template< auto Member >
+        auto& get() const noexcept {
+            return m_vector->template column<Member>()[m_index];
+        }
+
+        // gathers the listed fields into a record
+        operator T() const {
+            T record;
+            ( ( record.*Members = get<Members>() ), ... );
+            return record;
+        }
+
+        // scatters a record into the columns, the proxy keeps referring to element i
+        basic_reference& operator=( const T& record ) {
+            ( ( get<Members>() = record.*Members ), ... );
+            return *this;
+        }
+        basic_reference& operator=( T&& record ) {
+            ( ( get<Members>() = std::move( record.*Members ) ), ... );
+            return *this;
+        }
+        // assigning one element to another copies the fields, like *it1 = *it2 on a std::vector
+        basic_reference& operator=( const basic_reference& other ) {
+            ( ( get<Members>() = other.template get<Members>() ), ... );
+            return *this;
+        }
+        template< bool OtherConst >
+        basic_reference& operator=( const basic_reference<OtherConst>& other ) {
+            ( ( get<Members>() = other.template get<Members>() ), ... );
+            return *this;
+        }
+
+        size_type index() const noexcept { return m_index; }
+
+    private:
+        vector_type* m_vector;
+        size_type m_index;
+    };
+
+    using reference = basic_reference<false>;
+    using const_reference = basic_reference<true>;
+
+    //////////////////////////////////////////////////////////////////////////
+    // Iterators
+    //////////////////////////////////////////////////////////////////////////
+    // random access over proxies, the way std::vector<bool> iterates
+    template< bool Const >
+    class basic_iterator {
+        using vector_type = std::conditional_t<Const, const soa_vector, soa_vector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = basic_reference<Const>;
+        using pointer = void;
+
+        basic_iterator() noexcept = default;
+        basic_iterator( vector_type& v, size_type i ) noexcept : m_vector( &v ), m_index( i ) {}
+        // iterator to const_iterator
+        template< bool OtherConst, std::enable_if_t<Const && !OtherConst, int> = 0 >
+        basic_iterator( const basic_iterator<OtherConst>& other ) noexcept
+            : m_vector( other.m_vector ), m_index( other.m_index ) {}
+
+        reference operator*() const noexcept { return reference( *m_vector, m_index ); }
+        reference operator[]( difference_type n ) const noexcept { return *( *this + n ); }
+
+        basic_iterator& operator++() noexcept { ++m_index; return *this; }
+        basic_iterator operator++( int ) noexcept { basic_iterator old = *this; ++m_index; return old; }
+        basic_iterator& operator--() noexcept { --m_index; return *this; }
+        basic_iterator operator--( int ) noexcept { basic_iterator old = *this; --m_index; return old; }
+        basic_iterator& operator+=( difference_type n ) noexcept { m_index += n; return *this; }
+        basic_iterator& operator-=( difference_type n ) noexcept { m_index -= n; return *this; }
+
+        friend basic_iterator operator+( basic_iterator it, difference_type n ) noexcept { return it += n; }
+        friend basic_iterator operator+( difference_type n, basic_iterator it ) noexcept { return it += n; }
+        friend basic_iterator operator-( basic_iterator it, difference_type n ) noexcept { return it -= n; }
+        friend difference_type operator-( const basic_iterator& lhs, const basic_iterator& rhs ) noexcept {
+            return static_cast<difference_type>( lhs.m_index ) - static_cast<difference_type>( rhs.m_index );
+        }
+
+        friend bool operator==( const basic_iterator& lhs, const basic_iterator& rhs ) noexcept { return lhs.m_index == rhs.m_index; }
+        friend bool operator!=( const basic_iterator& lhs, const basic_iterator& rhs ) noexcept { return lhs.m_index != rhs.m_index; }
+        friend bool operator<( const basic_iterator& lhs, const basic_iterator& rhs ) noexcept { return lhs.m_index < rhs.m_index; }
+        friend bool operator>( const basic_iterator& lhs, const basic_iterator& rhs ) noexcept { return rhs < lhs; }
+        friend bool operator<=( const basic_iterator& lhs, const basic_iterator& rhs ) noexcept { return !( rhs < lhs ); }
+        friend bool operator>=( const basic_iterator& lhs, const basic_iterator& rhs ) noexcept { return !( lhs < rhs ); }
+
+    private:
+        template< bool >
+        friend class basic_iterator;
+
+        vector_type* m_vector = nullptr;
+        size_type m_index = 0;
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    //////////////////////////////////////////////////////////////////////////
+    // Construction
+    //////////////////////////////////////////////////////////////////////////
+    soa_vector() noexcept = default;
+
+    explicit soa_vector( size_type n ) { resize( n ); }
+    soa_vector( std::initializer_list<T> records ) {
+        reserve( records.size() );
+        for ( const T& record : records ) {
+            push_back( record );
+        }
+    }
+
+    soa_vector( const soa_vector& other ) {
+        reserve( other.m_size );
+        for_each_column_or_undo(
+            [&]( auto i ) { std::uninitialized_copy( other.column_data<i>(), other.column_data<i>() + other.m_size, column_data<i>() ); },
+            [&]( auto i ) { destroy_n( column_data<i>(), other.m_size ); } );
+        m_size = other.m_size;
+    }
+
+    soa_vector( soa_vector&& other ) noexcept { swap( other ); }
+
+    // copy-and-swap, one operator for both copy and move assignment
+    soa_vector& operator=( soa_vector other ) noexcept {
+        swap( other );
+        return *this;
+    }
+
+    ~soa_vector() {
+        clear();
+        deallocate( m_block );
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Access
+    //////////////////////////////////////////////////////////////////////////
+    size_type size() const noexcept { return m_size; }
+    size_type capacity() const noexcept { return m_capacity; }
+    bool empty() const noexcept { return m_size == 0; }
+
+    reference operator[]( size_type i ) noexcept { assert( i < m_size ); return reference( *this, i ); }
+    const_reference operator[]( size_type i ) const noexcept { assert( i < m_size ); return const_reference( *this, i ); }
+
+    iterator begin() noexcept { return iterator( *this, 0 ); }
+    iterator end() noexcept { return iterator( *this, m_size ); }
+    const_iterator begin() const noexcept { return const_iterator( *this, 0 ); }
+    const_iterator end() const noexcept { return const_iterator( *this, m_size ); }
+
+    // every element's Member, contiguous
+    template< auto Member >
+    column_span<detail::member_t<Member>> column() noexcept {
+        return { column_data<index_of<Member>()>(), m_size };
+    }
+    template< auto Member >
+    column_span<const detail::member_t<Member>> column() const noexcept {
+        return { column_data<index_of<Member>()>(), m_size };
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Capacity
+    //////////////////////////////////////////////////////////////////////////
+    void reserve( size_type n ) {
+        if ( n > m_capacity ) {
+            storage fresh = allocate( n );
+            for_each_column( [&]( auto i ) {
+                relocate_n( column_data<i>(), m_size, static_cast<field_at<i>*>( fresh.columns[i] ) );
+            } );
+            deallocate( m_block );
+            m_block = fresh.block;
+            m_columns = fresh.columns;
+            m_capacity = n;
+        }
+    }
+
+    // new elements have every listed field value-initialized
+    void resize( size_type n ) {
+        if ( n > m_size ) {
+            if ( n > m_capacity ) {
+                reserve( std::max( n, grown_capacity() ) );
+            }
+            for_each_column_or_undo( [&]( auto i ) { construct_n( column_data<i>() + m_size, n - m_size ); },
+                                     [&]( auto i ) { destroy_n( column_data<i>() + m_size, n - m_size ); } );
+        } else {
+            for_each_column( [&]( auto i ) { destroy_n( column_data<i>() + n, m_size - n ); } );
+        }
+        m_size = n;
+    }
+
+    void clear() noexcept {
+        for_each_column( [&]( auto i ) { destroy_n( column_data<i>(), m_size ); } );
+        m_size = 0;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Modifiers
+    //////////////////////////////////////////////////////////////////////////
+    // one argument per listed field, in field_list order
+    // the arguments must not refer into this vector, growing moves the columns
+    template< typename... Args >
+    reference emplace_back( Args&&... args ) {
+        static_assert( sizeof...( Args ) == field_count, "emplace_back takes one value per listed field" );
+        if ( m_size == m_capacity ) {
+            reserve( grown_capacity() );
+        }
+        auto values = std::forward_as_tuple( std::forward<Args>( args )... );
+        for_each_column_or_undo(
+            [&]( auto i ) {
+                new ( static_cast<void*>( column_data<i>() + m_size ) ) field_at<i>( std::get<i>( std::move( values ) ) );
+            },
+            [&]( auto i ) { destroy_n( column_data<i>() + m_size, 1 ); } );
+        return reference( *this, m_size++ );
+    }
+
+    void push_back( const T& record ) { emplace_back( record.*Members... ); }
+    void push_back( T&& record ) { emplace_back( std::move( record.*Members )... ); }
+
+    void pop_back() noexcept {
+        assert( m_size > 0 );
+        --m_size;
+        for_each_column( [&]( auto i ) { destroy_n( column_data<i>() + m_size, 1 ); } );
+    }
+
+    void swap( soa_vector& other ) noexcept {
+        std::swap( m_block, other.m_block );
+        std::swap( m_columns, other.m_columns );
+        std::swap( m_size, other.m_size );
+        std::swap( m_capacity, other.m_capacity );
+    }
+    friend void swap( soa_vector& lhs, soa_vector& rhs ) noexcept { lhs.swap( rhs ); }
+
+private:
+    struct storage {
+        void* block;
+        std::array<void*, field_count> columns;
+    };
+
+    // columns back to back in field_list order, each padded to the next soa_alignment boundary
+    static storage allocate( size_type capacity ) {
+        constexpr std::size_t sizes[] = { sizeof( detail::member_t<Members> )... };
+        std::array<std::size_t, field_count> offsets{};
+        std::size_t bytes = 0;
+        for ( std::size_t i = 0; i < field_count; ++i ) {
+            offsets[i] = bytes;
+            bytes = detail::align_up( bytes + capacity * sizes[i], soa_alignment );
+        }
+        storage s{ ::operator new( bytes, std::align_val_t( soa_alignment ) ), {} };
+        for ( std::size_t i = 0; i < field_count; ++i ) {
+            s.columns[i] = static_cast<char*>( s.block ) + offsets[i];
+        }
+        return s;
+    }
+    static void deallocate( void* block ) noexcept {
+        if ( block != nullptr ) {
+            ::operator delete( block, std::align_val_t( soa_alignment ) );
+        }
+    }
+
+    size_type grown_capacity() const noexcept { return m_capacity == 0 ? 16 : m_capacity * 2; }
+
+    template< std::size_t I >
+    field_at<I>* column_data() noexcept { return static_cast<field_at<I>*>( m_columns[I] ); }
+    template< std::size_t I >
+    const field_at<I>* column_data() const noexcept { return static_cast<const field_at<I>*>( m_columns[I] ); }
+
+    // f( std::integral_constant<std::size_t, I> ) for every column I
+    template< typename F, std::size_t... I >
+    static void for_each_column( F&& f, std::index_sequence<I...> ) {
+        ( f( std::integral_constant<std::size_t, I>{} ), ... );
+    }
+    template< typename F >
+    static void for_each_column( F&& f ) {
+        for_each_column( f, std::make_index_sequence<field_count>{} );
+    }
+
+    // f for every column, if one throws undo the columns already done
+    template< typename Do, typename Undo >
+    static void for_each_column_or_undo( Do&& f, Undo&& undo ) {
+        std::size_t done = 0;
+        try {
+            for_each_column( [&]( auto i ) {
+                f( i );
+                ++done;
+            } );
+        } catch ( ... ) {
+            for_each_column( [&]( auto i ) {
+                if ( i < done ) {
+                    undo( i );
+                }
+            } );
+            throw;
+        }
+    }
+
+    void* m_block = nullptr;
+    std::array<void*, field_count> m_columns{};
+    size_type m_size = 0;
+    size_type m_capacity = 0;
+};
+
+} // namespace perf
+
+#endif  // PERF_SOA_HPP
@@ -0,0 +1,335 @@
+//  perf/sorting_network.hpp  ------------------------------------------------//
+
+//  Fixed sequences of compare-exchanges that sort arrays of a size known at
+//  compile time, for the many tiny arrays of arrays_modern.cpp.
+//
+//  std::sort on six ints spends most of its time deciding what to do next:
+//  size checks, insertion sort loops and branches that mispredict on random
+//  data. A sorting network does the same comparisons whatever the input, so
+//  every compare-exchange can be a branchless min / max:
+//
+//      std::array<int, 6> a = { 5, 3, 6, 4, 1, 2 };
+//      perf::sort_network( a );
+//
+//  sort_network<N>        Batcher's odd-even merge network, generated at compile
+//                         time for any N and fully unrolled, any T and comparator
+//  sort_network_simd<N>   ints, N <= 32: a bitonic network across the lanes
+//                         of one to four AVX2 registers
+//
+//  Networks grow as N log^2 N, past a few dozen elements std::sort wins again.
+//  Neither sort is stable.
+
+#ifndef PERF_SORTING_NETWORK_HPP
+#define PERF_SORTING_NETWORK_HPP
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include "simd.hpp"
+
+namespace perf {
+
+namespace detail {
+
+//////////////////////////////////////////////////////////////////////////
+// Network generation
+//////////////////////////////////////////////////////////////////////////
+struct comparator {
+    std::size_t lo;
+    std::size_t hi;
+};
+
+// Batcher's odd-even merge sort for the next power of two, minus the comparators
+// that touch the padding (padding would be +infinity, those never swap)
+template< typename Emit >
+constexpr void odd_even_merge_network( std::size_t n, Emit&& emit ) {
+    for ( std::size_t p = 1; p < n; p *= 2 ) {
+        for ( std::size_t k = p; k >= 1; k /= 2 ) {
+            for ( std::size_t j = k % p; j + k < n; j += 2 * k ) {
+                for ( std::size_t i = 0; i < k && i + j + k < n; ++i ) {
+                    if ( ( i + j ) / ( 2 * p ) == ( i + j + k ) / ( 2 * p ) ) {
+                        emit( i + j, i + j + k );
+                    }
+                }
+            }
+        }
+    }
+}
+
+constexpr std::size_t network_size( std::size_t n ) {
+    std::size_t count = 0;
+    odd_even_merge_network( n, [&count]( std::size_t, std::size_t ) { ++count; } );
+    return count;
+}
+
+template< std::size_t N >
+struct network {
+    static constexpr std::size_t size = network_size( N );
+
+    static constexpr std::array<comparator, size> make() {
+        std::array<comparator, size> pairs{};
+        std::size_t next = 0;
+        odd_even_merge_network( N, [&]( std::size_t lo, std::size_t hi ) { pairs[next++] = comparator{ lo, hi }; } );
+        return pairs;
+    }
+
+    static constexpr std::array<comparator, size> pairs = make();
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Compare-exchange
+//////////////////////////////////////////////////////////////////////////
+// small trivially copyable types are selected without branches, anything else is swapped
+template< typename T >
+constexpr bool select_branchless = std::is_trivially_copyable<T>::value && sizeof( T ) <= 16;
+
+template< typename T, typename Compare >
+inline void compare_exchange( T& a, T& b, Compare& comp ) {
+    if constexpr ( std::is_arithmetic<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value ) {
+        // ?: on scalars becomes min / max or a conditional move
+        bool swap = comp( b, a );
+        T lo = swap ? b : a;
+        T hi = swap ? a : b;
+        a = lo;
+        b = hi;
+    } else if constexpr ( select_branchless<T> ) {
+        // ?: between structs is often compiled to branches, which mispredict half the
+        // time on random data, so blend the object representations with a mask instead
+        using word = std::conditional_t<sizeof( T ) <= 4, std::uint32_t, std::uint64_t>;
+        constexpr std::size_t words = ( sizeof( T ) + sizeof( word ) - 1 ) / sizeof( word );
+        word x[words] = {};
+        word y[words] = {};
+        std::memcpy( x, &a, sizeof( T ) );
+        std::memcpy( y, &b, sizeof( T ) );
+        word mask = word( 0 ) - static_cast<word>( comp( b, a ) );
+        for ( std::size_t i = 0; i < words; ++i ) {
+            word d = ( x[i] ^ y[i] ) & mask;
+            x[i] ^= d;
+            y[i] ^= d;
+        }
+        std::memcpy( &a, x, sizeof( T ) );
+        std::memcpy( &b, y, sizeof( T ) );
+    } else if ( comp( b, a ) ) {
+        using std::swap;
+        swap( a, b );
+    }
+}
+
+template< std::size_t N, typename T, typename Compare, std::size_t... I >
+inline void apply_network( T* x, Compare& comp, std::index_sequence<I...> ) {
+    constexpr auto& pairs = network<N>::pairs;
+    ( compare_exchange( x[pairs[I].lo], x[pairs[I].hi], comp ), ... );
+    (void)x;
+    (void)comp;
+}
+
+#if PERF_AVX2
+//////////////////////////////////////////////////////////////////////////
+// Bitonic sort in AVX2 registers
+//////////////////////////////////////////////////////////////////////////
+// element e of the sort is lane e % 8 of register e / 8, stages are (k, j) of the
+// textbook bitonic sort: e and e ^ j are compared, ascending where e & k is 0
+struct bitonic_stage {
+    int k;
+    int j;
+};
+
+constexpr int log2_int( int n ) {
+    int l = 0;
+    while ( ( 1 << l ) < n ) {
+        ++l;
+    }
+    return l;
+}
+
+template< int Elements >
+constexpr std::array<bitonic_stage, log2_int( Elements ) * ( log2_int( Elements ) + 1 ) / 2> bitonic_stages() {
+    std::array<bitonic_stage, log2_int( Elements ) * ( log2_int( Elements ) + 1 ) / 2> stages{};
+    std::size_t next = 0;
+    for ( int k = 2; k <= Elements; k *= 2 ) {
+        for ( int j = k / 2; j > 0; j /= 2 ) {
+            stages[next++] = bitonic_stage{ k, j };
+        }
+    }
+    return stages;
+}
+
+// lanes of register R that keep the larger value of their pair
+template< int K, int J, int R >
+constexpr int max_lanes() {
+    int mask = 0;
+    for ( int lane = 0; lane < 8; ++lane ) {
+        bool upper = ( lane & J ) != 0;
+        bool descending = ( ( R * 8 + lane ) & K ) != 0;
+        if ( upper != descending ) {
+            mask |= 1 << lane;
+        }
+    }
+    return mask;
+}
+
+// lane i gets lane i ^ J
+template< int J >
+inline __m256i partner( __m256i v ) noexcept {
+    if constexpr ( J == 1 ) {
+        return _mm256_shuffle_epi32( v, _MM_SHUFFLE( 2, 3, 0, 1 ) );
+    } else if constexpr ( J == 2 ) {
+        return _mm256_shuffle_epi32( v, _MM_SHUFFLE( 1, 0, 3, 2 ) );
+    } else {
+        return _mm256_permute2x128_si256( v, v, 1 );
+    }
+}
+
+template< int K, int J, int R >
+inline void bitonic_exchange( __m256i* v ) noexcept {
+    if constexpr ( J >= 8 ) {
+        // whole registers pair up
+        constexpr int P = R ^ ( J / 8 );
+        if constexpr ( R < P ) {
+            __m256i lo = _mm256_min_epi32( v[R], v[P] );
+            __m256i hi = _mm256_max_epi32( v[R], v[P] );
+            constexpr bool ascending = ( ( R * 8 ) & K ) == 0;
+            v[R] = ascending ? lo : hi;
+            v[P] = ascending ? hi : lo;
+        }
+    } else {
+        __m256i p = partner<J>( v[R] );
+        v[R] = _mm256_blend_epi32( _mm256_min_epi32( v[R], p ), _mm256_max_epi32( v[R], p ), max_lanes<K, J, R>() );
+    }
+}
+
+template< int Registers, std::size_t S, std::size_t... R >
+inline void bitonic_apply_stage( __m256i* v, std::index_sequence<R...> ) noexcept {
+    constexpr bitonic_stage stage = bitonic_stages<Registers * 8>()[S];
+    ( bitonic_exchange<stage.k, stage.j, static_cast<int>( R )>( v ), ... );
+}
+
+template< int Registers, std::size_t... S >
+inline void bitonic_sort( __m256i* v, std::index_sequence<S...> ) noexcept {
+    ( bitonic_apply_stage<Registers, S>( v, std::make_index_sequence<Registers>{} ), ... );
+}
+
+// loads M < 8 ints without touching memory past them, the other lanes hold INT_MAX
+// (a 32 byte masked load would overlap the next array and stall on its store)
+template< std::size_t M >
+inline __m128i load_partial4( const std::int32_t* x ) noexcept {
+    const __m128i padding = _mm_set1_epi32( INT_MAX );
+    if constexpr ( M == 0 ) {
+        return padding;
+    } else if constexpr ( M == 1 ) {
+        return _mm_insert_epi32( padding, x[0], 0 );
+    } else if constexpr ( M == 2 ) {
+        return _mm_blend_epi32( padding, _mm_loadl_epi64( reinterpret_cast<const __m128i*>( x ) ), 0x3 );
+    } else if constexpr ( M == 3 ) {
+        __m128i v = _mm_blend_epi32( padding, _mm_loadl_epi64( reinterpret_cast<const __m128i*>( x ) ), 0x3 );
+        return _mm_insert_epi32( v, x[2], 2 );
+    } else {
+        return _mm_loadu_si128( reinterpret_cast<const __m128i*>( x ) );
+    }
+}
+
+template< std::size_t M >
+inline __m256i load_partial( const std::int32_t* x ) noexcept {
+    if constexpr ( M >= 8 ) {
+        return _mm256_loadu_si256( reinterpret_cast<const __m256i*>( x ) );
+    } else if constexpr ( M > 4 ) {
+        return _mm256_inserti128_si256( _mm256_castsi128_si256( load_partial4<4>( x ) ), load_partial4<M - 4>( x + 4 ), 1 );
+    } else {
+        return _mm256_inserti128_si256( _mm256_castsi128_si256( load_partial4<M>( x ) ), _mm_set1_epi32( INT_MAX ), 1 );
+    }
+}
+
+template< std::size_t M >
+inline void store_partial4( std::int32_t* x, __m128i v ) noexcept {
+    if constexpr ( M >= 4 ) {
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( x ), v );
+    } else {
+        if constexpr ( M >= 2 ) {
+            _mm_storel_epi64( reinterpret_cast<__m128i*>( x ), v );
+        }
+        if constexpr ( M % 2 == 1 ) {
+            x[M - 1] = _mm_extract_epi32( v, M - 1 );
+        }
+    }
+}
+
+template< std::size_t M >
+inline void store_partial( std::int32_t* x, __m256i v ) noexcept {
+    if constexpr ( M >= 8 ) {
+        _mm256_storeu_si256( reinterpret_cast<__m256i*>( x ), v );
+    } else if constexpr ( M > 4 ) {
+        store_partial4<4>( x, _mm256_castsi256_si128( v ) );
+        store_partial4<M - 4>( x + 4, _mm256_extracti128_si256( v, 1 ) );
+    } else if constexpr ( M > 0 ) {
+        store_partial4<M>( x, _mm256_castsi256_si128( v ) );
+    }
+}
+
+template< std::size_t N, std::size_t... R >
+inline void load_registers( const std::int32_t* x, __m256i* v, std::index_sequence<R...> ) noexcept {
+    ( ( v[R] = load_partial<( N > R * 8 ? N - R * 8 : 0 )>( x + R * 8 ) ), ... );
+}
+
+template< std::size_t N, std::size_t... R >
+inline void store_registers( std::int32_t* x, const __m256i* v, std::index_sequence<R...> ) noexcept {
+    ( store_partial<( N > R * 8 ? N - R * 8 : 0 )>( x + R * 8, v[R] ), ... );
+}
+
+template< std::size_t N >
+inline void sort_network_avx2( std::int32_t* x ) noexcept {
+    constexpr int registers = N <= 8 ? 1 : N <= 16 ? 2 : 4;
+    // lanes past the end hold INT_MAX and stay at the end
+    __m256i v[registers];
+    load_registers<N>( x, v, std::make_index_sequence<registers>{} );
+    bitonic_sort<registers>( v, std::make_index_sequence<bitonic_stages<registers * 8>().size()>{} );
+    store_registers<N>( x, v, std::make_index_sequence<registers>{} );
+}
+#endif
+
+} // namespace detail
+
+//////////////////////////////////////////////////////////////////////////
+// sort_network
+//////////////////////////////////////////////////////////////////////////
+// sorts first[0, N) with comp, the same compare-exchanges whatever the values
+template< std::size_t N, typename T, typename Compare = std::less<> >
+void sort_network( T* first, Compare comp = {} ) {
+    detail::apply_network<N>( first, comp, std::make_index_sequence<detail::network<N>::size>{} );
+}
+
+template< typename T, std::size_t N, typename Compare = std::less<> >
+void sort_network( std::array<T, N>& a, Compare comp = {} ) {
+    sort_network<N>( a.data(), comp );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// sort_network_simd
+//////////////////////////////////////////////////////////////////////////
+// ascending sort of N <= 32 ints, in AVX2 registers when available
+template< std::size_t N >
+void sort_network_simd( std::int32_t* first ) noexcept {
+    static_assert( N <= 32, "sort_network_simd handles up to four registers of ints" );
+#if PERF_AVX2
+    if constexpr ( N > 1 ) {
+        detail::sort_network_avx2<N>( first );
+    }
+#else
+    sort_network<N>( first );
+#endif
+}
+
+template< std::size_t N >
+void sort_network_simd( std::array<std::int32_t, N>& a ) noexcept {
+    sort_network_simd<N>( a.data() );
+}
+
+} // namespace perf
+
+#endif  // PERF_SORTING_NETWORK_HPP
@@ -0,0 +1,308 @@
+//  perf/tracked_vector.hpp  -------------------------------------------------//
+
+//  A vector that keeps aggregates of its elements up to date as it changes.
+//
+//  Handing out std::vector<int>& (Widget::data() &) makes any cached sum
+//  unreliable: the caller can change anything and nobody is told. Wrap the
+//  vector instead, route every write through it, and let the registered
+//  aggregates see each change:
+//
+//      perf::tracked_vector<int, perf::sum_aggregate<int>, perf::minmax_tree<int>> values;
+//      values.push_back( 3 );
+//      values.set( 0, 7 );
+//      values[0] += 1;                                           // proxy, also tracked
+//      values.aggregate<perf::sum_aggregate<int>>().value();    // O(1), no rescan
+//      values.aggregate<perf::minmax_tree<int>>().min();        // O(1), updates are O(log n)
+//
+//  Aggregate                  update          query
+//  sum_aggregate<T>           O(1)            O(1)
+//  minmax_tree<T>             O(log n)        O(1) whole range, O(log n) sub-range
+//
+//  Writing your own: an aggregate is any default constructible type with
+//      void reset( const T* data, std::size_t n );                   // rebuild from scratch
+//      void before_write( const T* data, std::size_t first, std::size_t last );  // [first, last) about to change or go away
+//      void after_write( const T* data, std::size_t first, std::size_t last );   // [first, last) changed or appeared
+//  data points at element 0. A range write of k elements costs each aggregate
+//  one before_write + after_write pair, so it can batch the work.
+//
+//  Floating point sums are maintained by adding and subtracting, rounding error
+//  accumulates over many updates. Call rebuild() now and then if that matters.
+
+#ifndef PERF_TRACKED_VECTOR_HPP
+#define PERF_TRACKED_VECTOR_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "reduce.hpp"
+
+namespace perf {
+
+//////////////////////////////////////////////////////////////////////////
+// sum_aggregate
+//////////////////////////////////////////////////////////////////////////
+template< typename T, typename Acc = wide_t<T> >
+class sum_aggregate {
+public:
+    void reset( const T* data, std::size_t n ) {
+        m_sum = Acc{};
+        add( data, 0, n );
+    }
+    void before_write( const T* data, std::size_t first, std::size_t last ) {
+        for ( std::size_t i = first; i < last; ++i ) {
+            m_sum -= static_cast<Acc>( data[i] );
+        }
+    }
+    void after_write( const T* data, std::size_t first, std::size_t last ) { add( data, first, last ); }
+
+    Acc value() const noexcept { return m_sum; }
+
+private:
+    void add( const T* data, std::size_t first, std::size_t last ) {
+        for ( std::size_t i = first; i < last; ++i ) {
+            m_sum += static_cast<Acc>( data[i] );
+        }
+    }
+
+    Acc m_sum{};
+};
+
+//////////////////////////////////////////////////////////////////////////
+// minmax_tree
+//////////////////////////////////////////////////////////////////////////
+// bottom-up segment tree over a power of two leaves, node i covers nodes 2i and 2i+1
+template< typename T >
+class minmax_tree {
+public:
+    void reset( const T* data, std::size_t n ) { build( data, n, n ); }
+
+    void before_write( const T*, std::size_t first, std::size_t last ) {
+        for ( std::size_t i = first; i < last; ++i ) {
+            m_nodes[m_leaves + i] = identity();
+        }
+        pull_range( first, last );
+    }
+
+    void after_write( const T* data, std::size_t first, std::size_t last ) {
+        if ( last > m_leaves ) {
+            // grown past the leaves, doubling keeps this amortized O(1) per push_back
+            build( data, last, std::max( last, 2 * m_leaves ) );
+            return;
+        }
+        for ( std::size_t i = first; i < last; ++i ) {
+            m_nodes[m_leaves + i] = { data[i], data[i] };
+        }
+        pull_range( first, last );
+    }
+
+    // of the whole vector, meaningless when empty
+    T min() const noexcept { return m_nodes[1].min; }
+    T max() const noexcept { return m_nodes[1].max; }
+
+    // of [first, last), which must be non-empty
+    minmax_result<T> query( std::size_t first, std::size_t last ) const noexcept {
+        assert( first < last && last <= m_leaves );
+        minmax_result<T> result = identity();
+        for ( std::size_t l = first + m_leaves, r = last + m_leaves; l < r; l /= 2, r /= 2 ) {
+            if ( l & 1 ) {
+                combine( result, m_nodes[l++] );
+            }
+            if ( r & 1 ) {
+                combine( result, m_nodes[--r] );
+            }
+        }
+        return result;
+    }
+
+private:
+    // leaves for at least `capacity` elements, the first n taken from data
+    void build( const T* data, std::size_t n, std::size_t capacity ) {
+        std::size_t leaves = 1;
+        while ( leaves < capacity ) {
+            leaves *= 2;
+        }
+        m_leaves = leaves;
+        m_nodes.assign( 2 * leaves, identity() );
+        for ( std::size_t i = 0; i < n; ++i ) {
+            m_nodes[leaves + i] = { data[i], data[i] };
+        }
+        for ( std::size_t i = leaves - 1; i > 0; --i ) {
+            pull( i );
+        }
+    }
+
+    static minmax_result<T> identity() noexcept {
+        return { std::numeric_limits<T>::max(), std::numeric_limits<T>::lowest() };
+    }
+
+    static void combine( minmax_result<T>& into, const minmax_result<T>& other ) noexcept {
+        into.min = std::min( into.min, other.min );
+        into.max = std::max( into.max, other.max );
+    }
+
+    void pull( std::size_t i ) noexcept {
+        m_nodes[i] = m_nodes[2 * i];
+        combine( m_nodes[i], m_nodes[2 * i + 1] );
+    }
+
+    // recompute every ancestor of leaves [first, last) once, O(k + log n)
+    void pull_range( std::size_t first, std::size_t last ) noexcept {
+        if ( first >= last ) {
+            return;
+        }
+        for ( std::size_t l = ( first + m_leaves ) / 2, r = ( last - 1 + m_leaves ) / 2; l > 0; l /= 2, r /= 2 ) {
+            for ( std::size_t i = l; i <= r; ++i ) {
+                pull( i );
+            }
+        }
+    }
+
+    std::size_t m_leaves = 0;
+    std::vector<minmax_result<T>> m_nodes;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// tracked_vector
+//////////////////////////////////////////////////////////////////////////
+template< typename T, typename... Aggregates >
+class tracked_vector {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    // writes through to the vector, reads like a const T&
+    class reference {
+    public:
+        operator const T&() const noexcept { return m_owner->m_values[m_index]; }
+        reference& operator=( const T& value ) {
+            m_owner->set( m_index, value );
+            return *this;
+        }
+        reference& operator=( const reference& other ) { return *this = static_cast<const T&>( other ); }
+        reference& operator+=( const T& value ) { return *this = static_cast<const T&>( *this ) + value; }
+        reference& operator-=( const T& value ) { return *this = static_cast<const T&>( *this ) - value; }
+
+    private:
+        friend class tracked_vector;
+        reference( tracked_vector* owner, std::size_t index ) noexcept : m_owner( owner ), m_index( index ) {}
+
+        tracked_vector* m_owner;
+        std::size_t m_index;
+    };
+
+    tracked_vector() { rebuild(); }
+    explicit tracked_vector( std::vector<T> values ) : m_values( std::move( values ) ) { rebuild(); }
+    tracked_vector( std::initializer_list<T> values ) : m_values( values ) { rebuild(); }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Read access, never invalidates anything
+    //////////////////////////////////////////////////////////////////////////
+    size_type size() const noexcept { return m_values.size(); }
+    bool empty() const noexcept { return m_values.empty(); }
+    const T* data() const noexcept { return m_values.data(); }
+    const_iterator begin() const noexcept { return m_values.begin(); }
+    const_iterator end() const noexcept { return m_values.end(); }
+    const T& operator[]( size_type i ) const noexcept { return m_values[i]; }
+    const std::vector<T>& values() const noexcept { return m_values; }
+
+    template< typename Aggregate >
+    const Aggregate& aggregate() const noexcept { return std::get<Aggregate>( m_aggregates ); }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Tracked writes
+    //////////////////////////////////////////////////////////////////////////
+    reference operator[]( size_type i ) noexcept { return { this, i }; }
+
+    void set( size_type i, const T& value ) {
+        before_write( i, i + 1 );
+        m_values[i] = value;
+        after_write( i, i + 1 );
+    }
+
+    // f( T& ) may change the element any way it likes
+    template< typename F >
+    void modify( size_type i, F&& f ) {
+        before_write( i, i + 1 );
+        std::forward<F>( f )( m_values[i] );
+        after_write( i, i + 1 );
+    }
+
+    // overwrites [pos, pos + distance( first, last ) ), which must already exist
+    template< typename It >
+    void write( size_type pos, It first, It last ) {
+        auto count = static_cast<size_type>( std::distance( first, last ) );
+        assert( pos + count <= size() );
+        before_write( pos, pos + count );
+        std::copy( first, last, m_values.begin() + pos );
+        after_write( pos, pos + count );
+    }
+
+    void push_back( const T& value ) {
+        m_values.push_back( value );
+        after_write( size() - 1, size() );
+    }
+
+    template< typename It >
+    void append( It first, It last ) {
+        size_type old_size = size();
+        m_values.insert( m_values.end(), first, last );
+        after_write( old_size, size() );
+    }
+
+    void pop_back() {
+        before_write( size() - 1, size() );
+        m_values.pop_back();
+    }
+
+    void resize( size_type n, const T& value = T() ) {
+        size_type old_size = size();
+        if ( n < old_size ) {
+            before_write( n, old_size );
+            m_values.resize( n );
+        } else {
+            m_values.resize( n, value );
+            after_write( old_size, n );
+        }
+    }
+
+    void clear() {
+        m_values.clear();
+        rebuild();
+    }
+
+    void reserve( size_type n ) { m_values.reserve( n ); }
+
+    // hands the vector out for arbitrary changes, aggregates are rebuilt afterwards, O(n)
+    template< typename F >
+    void rewrite( F&& f ) {
+        std::forward<F>( f )( m_values );
+        rebuild();
+    }
+
+    void rebuild() {
+        std::apply( [this]( auto&... a ) { ( a.reset( m_values.data(), m_values.size() ), ... ); }, m_aggregates );
+    }
+
+private:
+    void before_write( size_type first, size_type last ) {
+        std::apply( [&]( auto&... a ) { ( a.before_write( m_values.data(), first, last ), ... ); }, m_aggregates );
+    }
+    void after_write( size_type first, size_type last ) {
+        std::apply( [&]( auto&... a ) { ( a.after_write( m_values.data(), first, last ), ... ); }, m_aggregates );
+    }
+
+    std::vector<T> m_values;
+    std::tuple<Aggregates...> m_aggregates;
+};
+
+} // namespace perf
+
+#endif  // PERF_TRACKED_VECTOR_HPP
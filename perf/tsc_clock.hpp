@@ -0,0 +1,264 @@
+//  perf/tsc_clock.hpp  ------------------------------------------------------//
+
+//  A std::chrono clock on top of the CPU time stamp counter, plus RAII timers.
+//
+//  steady_clock::now() goes through the vDSO and costs ~20ns. Reading the
+//  invariant TSC costs a handful of cycles. tsc_clock calibrates ticks against
+//  steady_clock once, on first use, and then satisfies the Clock requirements:
+//
+//      auto start = perf::tsc_clock::now();
+//      work();
+//      auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>( perf::tsc_clock::now() - start );
+//
+//  Its epoch is the steady_clock epoch, so time points of the two clocks can
+//  be compared directly.
+//
+//  Caveats: the TSC must be invariant (constant rate across P-states and
+//  synchronized between cores, true on every x86 server of the last decade,
+//  see is_invariant()). On other architectures tsc_clock is steady_clock.
+//
+//  Scoped timers record elapsed ticks into per-thread histograms, no locks or
+//  shared cache lines on the hot path:
+//
+//      void parse() {
+//          PERF_SCOPED_TIMER( "parse" );
+//          ...
+//      }
+//      perf::print_timer_report();
+
+#ifndef PERF_TSC_CLOCK_HPP
+#define PERF_TSC_CLOCK_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "histogram.hpp"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define PERF_HAS_TSC 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#else
+#define PERF_HAS_TSC 0
+#endif
+
+namespace perf {
+
+//////////////////////////////////////////////////////////////////////////
+// tsc_clock
+//////////////////////////////////////////////////////////////////////////
+class tsc_clock {
+public:
+    using rep = std::int64_t;
+    using period = std::nano;
+    using duration = std::chrono::nanoseconds;
+    using time_point = std::chrono::time_point<tsc_clock, duration>;
+    static constexpr bool is_steady = true;
+
+    static time_point now() noexcept { return from_ticks( ticks() ); }
+
+    // raw counter, may be reordered with surrounding instructions
+    static std::uint64_t ticks() noexcept {
+#if PERF_HAS_TSC
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>( std::chrono::steady_clock::now().time_since_epoch().count() );
+#endif
+    }
+
+    // waits for earlier instructions to finish before reading, use at the end of a measured region
+    static std::uint64_t ticks_serialized() noexcept {
+#if PERF_HAS_TSC
+        unsigned int aux;
+        return __rdtscp( &aux );
+#else
+        return ticks();
+#endif
+    }
+
+    static time_point from_ticks( std::uint64_t t ) noexcept {
+        const auto& c = calibration();
+        auto delta = static_cast<std::int64_t>( t - c.base_ticks );
+        return time_point( duration( c.base_ns + static_cast<rep>( static_cast<double>( delta ) * c.ns_per_tick ) ) );
+    }
+
+    static duration to_duration( std::uint64_t elapsed_ticks ) noexcept {
+        return duration( static_cast<rep>( static_cast<double>( elapsed_ticks ) * calibration().ns_per_tick ) );
+    }
+
+    static double ticks_per_second() noexcept { return 1e9 / calibration().ns_per_tick; }
+
+    static std::chrono::steady_clock::time_point to_steady( time_point t ) noexcept {
+        return std::chrono::steady_clock::time_point(
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>( t.time_since_epoch() ) );
+    }
+
+    // CPUID.80000007H:EDX[8], hypervisors sometimes hide it even when the TSC is fine
+    static bool is_invariant() noexcept {
+#if PERF_HAS_TSC && defined(_MSC_VER)
+        int regs[4];
+        __cpuid( regs, 0x80000007 );
+        return ( regs[3] & ( 1 << 8 ) ) != 0;
+#elif PERF_HAS_TSC
+        unsigned int eax, ebx, ecx, edx;
+        return __get_cpuid( 0x80000007, &eax, &ebx, &ecx, &edx ) && ( edx & ( 1u << 8 ) ) != 0;
+#else
+        return true;
+#endif
+    }
+
+private:
+    struct calibration_data {
+        std::uint64_t base_ticks;
+        rep base_ns;
+        double ns_per_tick;
+    };
+
+    // spin ~10ms against steady_clock, once per process
+    static const calibration_data& calibration() noexcept {
+        static const calibration_data data = [] {
+            using steady = std::chrono::steady_clock;
+            auto t0 = steady::now();
+            std::uint64_t c0 = ticks();
+            auto t1 = t0;
+            while ( t1 - t0 < std::chrono::milliseconds( 10 ) ) {
+                t1 = steady::now();
+            }
+            std::uint64_t c1 = ticks();
+            auto ns = std::chrono::duration_cast<duration>( t1 - t0 ).count();
+            double ns_per_tick = static_cast<double>( ns ) / static_cast<double>( c1 - c0 );
+            return calibration_data{ c0, std::chrono::duration_cast<duration>( t0.time_since_epoch() ).count(), ns_per_tick };
+        }();
+        return data;
+    }
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Per-thread histograms
+//////////////////////////////////////////////////////////////////////////
+// one logical histogram, each thread that records into it gets its own copy
+// objects of this type are meant to live as long as the program (statics)
+class thread_histograms {
+public:
+    thread_histograms() : m_index( next_index() ) {}
+    thread_histograms( const thread_histograms& ) = delete;
+    thread_histograms& operator=( const thread_histograms& ) = delete;
+
+    // this thread's histogram, created on first use
+    log_histogram& local() {
+        thread_local std::vector<log_histogram*> histograms;
+        if ( m_index >= histograms.size() ) {
+            histograms.resize( m_index + 1, nullptr );
+        }
+        log_histogram*& h = histograms[m_index];
+        if ( h == nullptr ) {
+            std::lock_guard<std::mutex> _{ m_mutex };
+            m_threads.push_back( std::make_unique<log_histogram>() );
+            h = m_threads.back().get();
+        }
+        return *h;
+    }
+
+    // all threads combined
+    log_histogram merged() const {
+        log_histogram total;
+        std::lock_guard<std::mutex> _{ m_mutex };
+        for ( auto& h : m_threads ) {
+            total.merge( *h );
+        }
+        return total;
+    }
+
+private:
+    static std::size_t next_index() {
+        static std::atomic<std::size_t> count{ 0 };
+        return count.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    std::size_t m_index;
+    mutable std::mutex m_mutex;
+    // histograms outlive their threads so the report still sees them
+    std::vector<std::unique_ptr<log_histogram>> m_threads;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Timer sites
+//////////////////////////////////////////////////////////////////////////
+// a named statistic in ticks, listed by print_timer_report
+class timer_site {
+public:
+    explicit timer_site( const char* name ) : m_name( name ) {
+        std::lock_guard<std::mutex> _{ registry_mutex() };
+        registry().push_back( this );
+    }
+    timer_site( const timer_site& ) = delete;
+    timer_site& operator=( const timer_site& ) = delete;
+
+    const char* name() const noexcept { return m_name; }
+    log_histogram& local() { return m_histograms.local(); }
+    log_histogram merged() const { return m_histograms.merged(); }
+
+    static std::vector<timer_site*> all() {
+        std::lock_guard<std::mutex> _{ registry_mutex() };
+        return registry();
+    }
+
+private:
+    static std::vector<timer_site*>& registry() {
+        static std::vector<timer_site*> sites;
+        return sites;
+    }
+    static std::mutex& registry_mutex() {
+        static std::mutex m;
+        return m;
+    }
+
+    const char* m_name;
+    thread_histograms m_histograms;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// scoped_timer
+//////////////////////////////////////////////////////////////////////////
+class scoped_timer {
+public:
+    explicit scoped_timer( timer_site& site ) : m_histogram( site.local() ), m_start( tsc_clock::ticks() ) {}
+    scoped_timer( const scoped_timer& ) = delete;
+    scoped_timer& operator=( const scoped_timer& ) = delete;
+    ~scoped_timer() { m_histogram.record( tsc_clock::ticks_serialized() - m_start ); }
+
+private:
+    log_histogram& m_histogram;
+    std::uint64_t m_start;
+};
+
+#define PERF_TIMER_CONCAT2( a, b ) a##b
+#define PERF_TIMER_CONCAT( a, b ) PERF_TIMER_CONCAT2( a, b )
+// times the rest of the enclosing scope into a static site named `name`
+#define PERF_SCOPED_TIMER( name )                                                        \
+    static ::perf::timer_site PERF_TIMER_CONCAT( perf_timer_site_, __LINE__ ){ name };   \
+    ::perf::scoped_timer PERF_TIMER_CONCAT( perf_scoped_timer_, __LINE__ ) { PERF_TIMER_CONCAT( perf_timer_site_, __LINE__ ) }
+
+inline void print_timer_report( std::FILE* out = stdout ) {
+    auto ns = []( std::uint64_t ticks ) { return static_cast<double>( tsc_clock::to_duration( ticks ).count() ); };
+    std::fprintf( out, "%-24s %10s %10s %10s %10s %10s\n", "timer", "count", "p50 ns", "p99 ns", "p99.9 ns", "max ns" );
+    for ( auto* site : timer_site::all() ) {
+        log_histogram h = site->merged();
+        std::fprintf( out, "%-24s %10llu %10.0f %10.0f %10.0f %10.0f\n", site->name(),
+                      static_cast<unsigned long long>( h.count() ), ns( h.percentile( 0.5 ) ),
+                      ns( h.percentile( 0.99 ) ), ns( h.percentile( 0.999 ) ), ns( h.max() ) );
+    }
+}
+
+} // namespace perf
+
+#endif  // PERF_TSC_CLOCK_HPP
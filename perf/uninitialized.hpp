@@ -0,0 +1,144 @@
+//  perf/uninitialized.hpp  --------------------------------------------------//
+
+//  Bulk versions of the placement new `construct` wrapper from
+//  variadic_modern.cpp: construct_n, default_construct_n, relocate_n and
+//  destroy_n.
+//
+//  Relocation is "move construct into new storage, then destroy the source".
+//  For most types that is the same as copying the bytes and forgetting the
+//  source, so relocate_n turns into a single memmove when the type is
+//  trivially relocatable:
+//  - every trivially copyable type is, detected automatically
+//  - other types opt in by specializing perf::is_trivially_relocatable,
+//    e.g. types holding std::unique_ptr or std::vector
+//  Do not opt in types that store pointers into themselves (libstdc++'s
+//  std::string is one of those).
+
+#ifndef PERF_UNINITIALIZED_HPP
+#define PERF_UNINITIALIZED_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace perf {
+
+//////////////////////////////////////////////////////////////////////////
+// is_trivially_relocatable
+//////////////////////////////////////////////////////////////////////////
+// opt in with: template<> struct perf::is_trivially_relocatable<MyType> : std::true_type {};
+template< typename T >
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template< typename T >
+constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+//////////////////////////////////////////////////////////////////////////
+// destroy_n
+//////////////////////////////////////////////////////////////////////////
+template< typename T >
+void destroy_n( T* first, std::size_t n ) noexcept {
+    if constexpr ( !std::is_trivially_destructible<T>::value ) {
+        for ( std::size_t i = 0; i < n; ++i ) {
+            first[i].~T();
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// construct_n
+//////////////////////////////////////////////////////////////////////////
+// constructs n objects from the same arguments, construct_n(p, n) value-initializes
+// if a constructor throws, the objects this call built are destroyed before the exception
+// propagates; [first, first + n) is raw memory again, undoing anything else is up to the caller
+template< typename T, typename... Args >
+void construct_n( T* first, std::size_t n, const Args&... args ) {
+    if ( n == 0 ) {
+        return;
+    }
+    if constexpr ( sizeof...( Args ) == 0 && std::is_trivial<T>::value ) {
+        // value-initialization of a trivial type is zero-initialization
+        std::memset( static_cast<void*>( first ), 0, n * sizeof( T ) );
+    } else if constexpr ( sizeof...( Args ) == 1 && ( std::is_same<T, std::decay_t<Args>>::value && ... ) &&
+                          std::is_trivially_copyable<T>::value ) {
+        // copy one element, then double the initialized prefix with memcpy
+        new ( static_cast<void*>( first ) ) T( args... );
+        std::size_t done = 1;
+        while ( done < n ) {
+            std::size_t chunk = done < n - done ? done : n - done;
+            std::memcpy( static_cast<void*>( first + done ), first, chunk * sizeof( T ) );
+            done += chunk;
+        }
+    } else {
+        std::size_t i = 0;
+        try {
+            for ( ; i < n; ++i ) {
+                new ( static_cast<void*>( first + i ) ) T( args... );
+            }
+        } catch ( ... ) {
+            destroy_n( first, i );
+            throw;
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// default_construct_n
+//////////////////////////////////////////////////////////////////////////
+// default-initializes n objects: trivial types are left uninitialized, which is
+// the point, others run their default constructor
+template< typename T >
+void default_construct_n( T* first, std::size_t n ) {
+    if constexpr ( !std::is_trivially_default_constructible<T>::value ) {
+        std::size_t i = 0;
+        try {
+            for ( ; i < n; ++i ) {
+                new ( static_cast<void*>( first + i ) ) T;
+            }
+        } catch ( ... ) {
+            destroy_n( first, i );
+            throw;
+        }
+    } else {
+        (void)first;
+        (void)n;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// relocate_n
+//////////////////////////////////////////////////////////////////////////
+// moves n objects from first to dest and ends the lifetime of the sources
+// the ranges may overlap, so this also shifts elements inside one buffer
+template< typename T >
+void relocate_n( T* first, std::size_t n, T* dest ) noexcept {
+    if ( n == 0 || first == dest ) {
+        return;
+    }
+    if constexpr ( is_trivially_relocatable_v<T> ) {
+        std::memmove( static_cast<void*>( dest ), static_cast<const void*>( first ), n * sizeof( T ) );
+    } else {
+        static_assert( std::is_nothrow_move_constructible<T>::value,
+                       "relocate_n needs a noexcept move constructor or a trivially relocatable type" );
+        auto relocate_one = []( T* from, T* to ) {
+            new ( static_cast<void*>( to ) ) T( std::move( *from ) );
+            from->~T();
+        };
+        if ( dest < first ) {
+            for ( std::size_t i = 0; i < n; ++i ) {
+                relocate_one( first + i, dest + i );
+            }
+        } else {
+            for ( std::size_t i = n; i-- > 0; ) {
+                relocate_one( first + i, dest + i );
+            }
+        }
+    }
+}
+
+} // namespace perf
+
+#endif  // PERF_UNINITIALIZED_HPP
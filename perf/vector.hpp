@@ -0,0 +1,271 @@
+//  perf/vector.hpp  ---------------------------------------------------------//
+
+//  A std::vector look-alike built on perf/uninitialized.hpp.
+//
+//  Growing, inserting and erasing move elements with relocate_n, so for
+//  trivially relocatable types a reallocation or a shift is one memmove
+//  instead of a move-construct + destroy loop per element. std::vector can
+//  only do that for trivially copyable types.
+//
+//  Element types need a noexcept move constructor unless they are trivially
+//  relocatable.
+
+#ifndef PERF_VECTOR_HPP
+#define PERF_VECTOR_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "uninitialized.hpp"
+
+namespace perf {
+
+template< typename T >
+class vector {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    //////////////////////////////////////////////////////////////////////////
+    // Construction
+    //////////////////////////////////////////////////////////////////////////
+    vector() noexcept = default;
+
+    explicit vector( size_type n ) : vector() { resize( n ); }
+    vector( size_type n, const T& value ) : vector() { resize( n, value ); }
+    vector( std::initializer_list<T> values ) : vector() {
+        reserve( values.size() );
+        std::uninitialized_copy( values.begin(), values.end(), m_data );
+        m_size = values.size();
+    }
+
+    vector( const vector& other ) : vector() {
+        reserve( other.m_size );
+        std::uninitialized_copy( other.begin(), other.end(), m_data );
+        m_size = other.m_size;
+    }
+
+    vector( vector&& other ) noexcept { swap( other ); }
+
+    // copy-and-swap, one operator for both copy and move assignment
+    vector& operator=( vector other ) noexcept {
+        swap( other );
+        return *this;
+    }
+
+    ~vector() {
+        destroy_n( m_data, m_size );
+        deallocate( m_data, m_capacity );
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Access
+    //////////////////////////////////////////////////////////////////////////
+    size_type size() const noexcept { return m_size; }
+    size_type capacity() const noexcept { return m_capacity; }
+    bool empty() const noexcept { return m_size == 0; }
+
+    T* data() noexcept { return m_data; }
+    const T* data() const noexcept { return m_data; }
+
+    iterator begin() noexcept { return m_data; }
+    iterator end() noexcept { return m_data + m_size; }
+    const_iterator begin() const noexcept { return m_data; }
+    const_iterator end() const noexcept { return m_data + m_size; }
+
+    T& operator[]( size_type i ) noexcept { assert( i < m_size ); return m_data[i]; }
+    const T& operator[]( size_type i ) const noexcept { assert( i < m_size ); return m_data[i]; }
+    T& front() noexcept { return ( *this )[0]; }
+    const T& front() const noexcept { return ( *this )[0]; }
+    T& back() noexcept { return ( *this )[m_size - 1]; }
+    const T& back() const noexcept { return ( *this )[m_size - 1]; }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Capacity
+    //////////////////////////////////////////////////////////////////////////
+    void reserve( size_type n ) {
+        if ( n > m_capacity ) {
+            T* fresh = allocate( n );
+            relocate_n( m_data, m_size, fresh );
+            deallocate( m_data, m_capacity );
+            m_data = fresh;
+            m_capacity = n;
+        }
+    }
+
+    template< typename... Value >
+    void resize( size_type n, const Value&... value ) {
+        static_assert( sizeof...( Value ) <= 1, "resize(n) or resize(n, value)" );
+        if ( n > m_size ) {
+            if ( n > m_capacity ) {
+                reallocate_resize( n, value... );
+                return;
+            }
+            construct_n( m_data + m_size, n - m_size, value... );
+        } else {
+            destroy_n( m_data + n, m_size - n );
+        }
+        m_size = n;
+    }
+
+    // like resize(n), but new elements are default-initialized: for trivial types
+    // nothing is written, the caller is expected to overwrite them all
+    void resize_uninitialized( size_type n ) {
+        if ( n > m_size ) {
+            if ( n > m_capacity ) {
+                reserve( std::max( n, grown_capacity() ) );
+            }
+            default_construct_n( m_data + m_size, n - m_size );
+        } else {
+            destroy_n( m_data + n, m_size - n );
+        }
+        m_size = n;
+    }
+
+    void clear() noexcept {
+        destroy_n( m_data, m_size );
+        m_size = 0;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Modifiers
+    //////////////////////////////////////////////////////////////////////////
+    template< typename... Args >
+    T& emplace_back( Args&&... args ) {
+        if ( m_size == m_capacity ) {
+            return *reallocate_emplace( m_size, std::forward<Args>( args )... );
+        }
+        T* p = new ( static_cast<void*>( m_data + m_size ) ) T( std::forward<Args>( args )... );
+        ++m_size;
+        return *p;
+    }
+
+    void push_back( const T& value ) { emplace_back( value ); }
+    void push_back( T&& value ) { emplace_back( std::move( value ) ); }
+
+    void pop_back() noexcept {
+        assert( m_size > 0 );
+        destroy_n( m_data + --m_size, 1 );
+    }
+
+    template< typename... Args >
+    iterator emplace( const_iterator pos, Args&&... args ) {
+        auto i = static_cast<size_type>( pos - m_data );
+        if ( m_size == m_capacity ) {
+            return reallocate_emplace( i, std::forward<Args>( args )... );
+        }
+        if ( i == m_size ) {
+            return &emplace_back( std::forward<Args>( args )... );
+        }
+        // build first, the arguments may refer to elements that are about to shift
+        T value( std::forward<Args>( args )... );
+        relocate_n( m_data + i, m_size - i, m_data + i + 1 );
+        new ( static_cast<void*>( m_data + i ) ) T( std::move( value ) );
+        ++m_size;
+        return m_data + i;
+    }
+
+    iterator insert( const_iterator pos, const T& value ) { return emplace( pos, value ); }
+    iterator insert( const_iterator pos, T&& value ) { return emplace( pos, std::move( value ) ); }
+
+    iterator erase( const_iterator first, const_iterator last ) noexcept {
+        auto i = static_cast<size_type>( first - m_data );
+        auto n = static_cast<size_type>( last - first );
+        destroy_n( m_data + i, n );
+        relocate_n( m_data + i + n, m_size - i - n, m_data + i );
+        m_size -= n;
+        return m_data + i;
+    }
+
+    iterator erase( const_iterator pos ) noexcept { return erase( pos, pos + 1 ); }
+
+    void swap( vector& other ) noexcept {
+        std::swap( m_data, other.m_data );
+        std::swap( m_size, other.m_size );
+        std::swap( m_capacity, other.m_capacity );
+    }
+    friend void swap( vector& lhs, vector& rhs ) noexcept { lhs.swap( rhs ); }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Comparison operators
+    //////////////////////////////////////////////////////////////////////////
+    friend bool operator==( const vector& lhs, const vector& rhs ) {
+        return std::equal( lhs.begin(), lhs.end(), rhs.begin(), rhs.end() );
+    }
+    friend bool operator<( const vector& lhs, const vector& rhs ) {
+        return std::lexicographical_compare( lhs.begin(), lhs.end(), rhs.begin(), rhs.end() );
+    }
+    friend bool operator!=( const vector& lhs, const vector& rhs ) { return !( lhs == rhs ); }
+    friend bool operator>( const vector& lhs, const vector& rhs ) { return rhs < lhs; }
+    friend bool operator<=( const vector& lhs, const vector& rhs ) { return !( rhs < lhs ); }
+    friend bool operator>=( const vector& lhs, const vector& rhs ) { return !( lhs < rhs ); }
+
+private:
+    static T* allocate( size_type n ) { return n == 0 ? nullptr : std::allocator<T>{}.allocate( n ); }
+    static void deallocate( T* p, size_type n ) noexcept {
+        if ( p != nullptr ) {
+            std::allocator<T>{}.deallocate( p, n );
+        }
+    }
+
+    size_type grown_capacity() const noexcept { return m_capacity == 0 ? 4 : m_capacity * 2; }
+
+    // grow and construct the new element at index i in one pass over the old elements
+    template< typename... Args >
+    T* reallocate_emplace( size_type i, Args&&... args ) {
+        size_type capacity = grown_capacity();
+        T* fresh = allocate( capacity );
+        try {
+            new ( static_cast<void*>( fresh + i ) ) T( std::forward<Args>( args )... );
+        } catch ( ... ) {
+            deallocate( fresh, capacity );
+            throw;
+        }
+        relocate_n( m_data, i, fresh );
+        relocate_n( m_data + i, m_size - i, fresh + i + 1 );
+        deallocate( m_data, m_capacity );
+        m_data = fresh;
+        m_capacity = capacity;
+        ++m_size;
+        return fresh + i;
+    }
+
+    // grow to hold n, the new tail is built before the old elements move
+    // so value may refer to one of them, as in v.resize( n, v[0] )
+    template< typename... Value >
+    void reallocate_resize( size_type n, const Value&... value ) {
+        size_type capacity = std::max( n, grown_capacity() );
+        T* fresh = allocate( capacity );
+        try {
+            construct_n( fresh + m_size, n - m_size, value... );
+        } catch ( ... ) {
+            deallocate( fresh, capacity );
+            throw;
+        }
+        relocate_n( m_data, m_size, fresh );
+        deallocate( m_data, m_capacity );
+        m_data = fresh;
+        m_capacity = capacity;
+        m_size = n;
+    }
+
+    T* m_data = nullptr;
+    size_type m_size = 0;
+    size_type m_capacity = 0;
+};
+
+} // namespace perf
+
+#endif  // PERF_VECTOR_HPP
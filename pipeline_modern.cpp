@@ -0,0 +1,93 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <cstdio>
+
+#include "perf/pipeline.hpp"
+#include "perf/bench.hpp"
+
+bool is_even( int x ) { return ( x & 1 ) == 0; }
+bool is_odd( int x ) { return !is_even( x ); }
+
+struct divisible_by {
+    int d;
+    bool operator()( int x ) const { return x % d == 0; }
+};
+
+constexpr int primes[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29 };
+
+//////////////////////////////////////////////////////////////////////////
+// The same chain two ways
+//////////////////////////////////////////////////////////////////////////
+// one erase-remove pass per stage
+template< std::size_t... I >
+void erase_remove_chain( std::vector<int>& values, std::index_sequence<I...> ) {
+    ( values.erase( std::remove_if( values.begin(), values.end(), divisible_by{ primes[I] } ), values.end() ), ... );
+}
+
+// every stage in one pass
+template< std::size_t... I >
+void fused_chain( std::vector<int>& values, std::index_sequence<I...> ) {
+    perf::in_place( values, ( perf::pipeline<>{} | ... | perf::reject( divisible_by{ primes[I] } ) ) );
+}
+
+template< std::size_t... Stages >
+void benchmark( const std::vector<int>& source, std::index_sequence<Stages...> ) {
+    std::vector<int> work;
+    auto run = [&]( auto stages ) {
+        double chain = perf::time_ms( [&] { work = source; erase_remove_chain( work, stages ); } );
+        std::vector<int> expected = work;
+        double fused = perf::time_ms( [&] { work = source; fused_chain( work, stages ); } );
+        std::printf( "  %2zu stages %10.3f ms %10.3f ms %6.2fx%s\n", stages.size(), chain, fused, chain / fused,
+                     work == expected ? "" : "  MISMATCH" );
+    };
+    ( run( std::make_index_sequence<Stages + 1>{} ), ... );
+}
+
+int main() {
+    //////////////////////////////////////////////////////////////////////////
+    // Lazy views
+    //////////////////////////////////////////////////////////////////////////
+    std::vector<int> values{ 0, 1, 2, 3, 4, 5 };
+    // nothing happens here, the view just remembers the source and the stages
+    auto odd_squares = perf::from( values ) | perf::reject( is_even ) | perf::transform( []( int x ) { return x * x; } );
+    // one pass, no intermediate vector
+    for ( int x : odd_squares.to_vector() ) {
+        std::cout << x << " ";
+    }
+    std::cout << "count " << odd_squares.count() << std::endl;
+    // a filter alone keeps the source's elements, copied out as values
+    std::vector<int> odds = ( perf::from( values ) | perf::reject( is_even ) ).to_vector();
+    std::cout << odds.size() << " " << perf::from( values ).to_vector().size() << std::endl;
+
+    //////////////////////////////////////////////////////////////////////////
+    // Fusing erase-remove chains
+    //////////////////////////////////////////////////////////////////////////
+    // auto_modern.cpp does two full passes
+    //   values.erase( std::remove_if( begin( values ), end( values ), is_even ), end( values ) );
+    //   values.erase( std::remove_if( begin( values ), end( values ), is_odd ), end( values ) );
+    perf::in_place( values, perf::reject( is_even ) | perf::reject( is_odd ) );
+    std::cout << values.size() << std::endl;
+
+    const std::size_t count = 10'000'000;
+    std::mt19937 rng( 3 );
+    std::vector<int> source( count );
+    std::generate( source.begin(), source.end(), [&] { return static_cast<int>( rng() >> 1 ); } );
+    std::printf( "reject multiples of the first N primes from %zu ints\n", count );
+    std::printf( "  %9s %13s %13s\n", "", "erase-remove", "fused" );
+    benchmark( source, std::make_index_sequence<10>{} );
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Summary
+//////////////////////////////////////////////////////////////////////////
+/*
+Every erase-remove pass streams the whole vector through the cache again.
+Fusing the stages touches each element once and stops evaluating stages once it's rejected.
+
+Lazy means nothing runs until you ask for the result, so building the pipeline is free.
+Watch the lifetime: a view refers to its source, it doesn't own it.
+*/
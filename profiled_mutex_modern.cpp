@@ -0,0 +1,131 @@
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <numeric>
+#include <mutex>
+#include <thread>
+#include <cstdio>
+
+#include "perf/profiled_mutex.hpp"
+#include "perf/bench.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+// The qualifiers_modern.cpp Widget, instrumented
+//////////////////////////////////////////////////////////////////////////
+// one site for the mutex of every Widget, the report shows them as one line
+static perf::lock_site widget_cache_site{ "Widget::m_cached_mutex" };
+
+class Widget {
+public:
+    explicit Widget( std::vector<int> data ) : m_data( std::move( data ) ) {}
+
+    int sum() const {
+        std::lock_guard<perf::profiled_mutex<>> _{ m_cached_mutex };
+        if ( m_cached == -1 ) {
+            m_cached = std::accumulate( begin( m_data ), end( m_data ), 0 );
+        }
+        return m_cached;
+    }
+
+private:
+    std::vector<int> m_data;
+
+    mutable perf::profiled_mutex<> m_cached_mutex{ widget_cache_site };
+    mutable int m_cached = -1;
+};
+
+// a lock that is held for a while, the kind the report should point at
+static perf::lock_site queue_site{ "work_queue" };
+perf::profiled_mutex<> queue_mutex{ queue_site };
+std::vector<int> queue;
+
+void produce( int items ) {
+    for ( int i = 0; i < items; ++i ) {
+        std::lock_guard<perf::profiled_mutex<>> _{ queue_mutex };
+        queue.push_back( i );
+        // pretend to do some work while holding it
+        for ( int spin = 0; spin < 200; ++spin ) {
+            perf::do_not_optimize( spin );
+        }
+    }
+}
+
+int main() {
+    //////////////////////////////////////////////////////////////////////////
+    // Overhead when uncontended
+    //////////////////////////////////////////////////////////////////////////
+    const int locks = 10'000'000;
+    std::mutex plain;
+    perf::profiled_mutex<> profiled;
+    auto report = [locks]( const char* name, double ms ) {
+        std::printf( "  %-28s %6.2f ns/lock+unlock\n", name, ms * 1e6 / locks );
+    };
+    std::printf( "%d uncontended lock/unlock pairs\n", locks );
+    report( "std::mutex", perf::time_ms( [&] {
+        for ( int i = 0; i < locks; ++i ) {
+            std::lock_guard<std::mutex> _{ plain };
+            perf::do_not_optimize( i );
+        }
+    } ) );
+    // what profiled_mutex does first, the floor for anything that detects contention this way
+    report( "std::mutex try_lock", perf::time_ms( [&] {
+        for ( int i = 0; i < locks; ++i ) {
+            if ( !plain.try_lock() ) {
+                plain.lock();
+            }
+            perf::do_not_optimize( i );
+            plain.unlock();
+        }
+    } ) );
+    report( "perf::profiled_mutex", perf::time_ms( [&] {
+        for ( int i = 0; i < locks; ++i ) {
+            std::lock_guard<perf::profiled_mutex<>> _{ profiled };
+            perf::do_not_optimize( i );
+        }
+    } ) );
+    // opting in to timing every hold
+    static perf::lock_site every_hold_site{ "every hold timed", 1 };
+    perf::profiled_mutex<> every_hold{ every_hold_site };
+    report( "perf::profiled_mutex, every", perf::time_ms( [&] {
+        for ( int i = 0; i < locks; ++i ) {
+            std::lock_guard<perf::profiled_mutex<>> _{ every_hold };
+            perf::do_not_optimize( i );
+        }
+    } ) );
+
+    //////////////////////////////////////////////////////////////////////////
+    // Finding the hot lock
+    //////////////////////////////////////////////////////////////////////////
+    // Widget isn't movable (neither is a mutex), deque never moves its elements
+    std::deque<Widget> widgets;
+    for ( int i = 0; i < 4; ++i ) {
+        widgets.emplace_back( std::vector<int>( 1000, i ) );
+    }
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < 4; ++t ) {
+        threads.emplace_back( [&widgets, t] {
+            for ( int i = 0; i < 200'000; ++i ) {
+                perf::do_not_optimize( widgets[( t + i ) % widgets.size()].sum() );
+            }
+            produce( 20'000 );
+        } );
+    }
+    for ( auto& t : threads ) {
+        t.join();
+    }
+    std::cout << queue.size() << " items queued" << std::endl;
+    perf::print_lock_report();
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Summary
+//////////////////////////////////////////////////////////////////////////
+/*
+Lock contention is invisible in a CPU profile: waiting threads are asleep, not burning cycles.
+Measure it at the lock.
+
+try_lock first, only start the clock when it fails, and time a sample of the holds rather than all of them: the uncontended path stays cheap enough to leave on.
+Reading the TSC is not free either. Two reads per lock cost several times more than the lock itself.
+Aggregate per call site, not per object, so a mutex in every Widget stays small and the report stays readable.
+*/
@@ -19,6 +19,7 @@ public:
 	//////////////////////////////////////////////////////////////////////////
 	// ref qualifiers can present optimization opportunities
 	// use sparingly, makes code more complicated
+	// a mutable reference to m_data also means m_cached below can go stale, tracked_vector_modern.cpp keeps it current
 	const std::vector<int>& data() const & { return m_data;  }
 	std::vector<int>& data() & { return m_data; }
 	std::vector<int>&& data() && { return std::move(m_data); }
@@ -29,6 +30,7 @@ public:
 	// if a cached value updated by const function make it mutable
 	// is it ever possible for an instance of the type to be accessed from multiple threads concurrently?
 	// then you must create an internal mutable mutex to guard access to cached value
+	// readers still serialize on that mutex, perf::cached<int> in cached_modern.cpp skips the lock once filled
 	int sum() const { 
 		std::lock_guard<std::mutex> _{m_cached_mutex};
 		if (m_cached == -1) {
@@ -0,0 +1,89 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdio>
+
+#include "perf/radix_sort.hpp"
+#include "perf/bench.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+// RegularWidget from class_modern.cpp
+//////////////////////////////////////////////////////////////////////////
+class RegularWidget {
+public:
+    RegularWidget() = default;
+    explicit RegularWidget( int ordinal ) : m_ordinal( ordinal ) {}
+
+    // the radix sort key
+    int ordinal() const { return m_ordinal; }
+
+    friend bool operator==( const RegularWidget& lhs, const RegularWidget& rhs ) { return lhs.m_ordinal == rhs.m_ordinal; }
+    friend bool operator<( const RegularWidget& lhs, const RegularWidget& rhs ) { return lhs.m_ordinal < rhs.m_ordinal; }
+
+private:
+    int m_ordinal = 0;
+};
+
+// the sort key, &RegularWidget::ordinal works too but a lambda is always inlined
+const auto by_ordinal = []( const RegularWidget& w ) { return w.ordinal(); };
+
+void benchmark( std::size_t n ) {
+    std::mt19937 rng( 42 );
+    std::vector<RegularWidget> shuffled;
+    shuffled.reserve( n );
+    for ( std::size_t i = 0; i < n; ++i ) {
+        shuffled.emplace_back( static_cast<int>( rng() ) );
+    }
+
+    // one run each, a second run would sort sorted data
+    std::vector<RegularWidget> expected = shuffled;
+    double std_sort = perf::time_ms( [&] { std::sort( expected.begin(), expected.end() ); }, 1 );
+
+    auto measure = [&]( const char* name, auto sort ) {
+        std::vector<RegularWidget> widgets = shuffled;
+        double ms = perf::time_ms( [&] { sort( widgets ); }, 1 );
+        std::printf( "  %-32s %10.1f ms %8.2fx %s\n", name, ms, std_sort / ms, widgets == expected ? "" : "WRONG" );
+    };
+    std::printf( "%zu widgets\n", n );
+    std::printf( "  %-32s %10.1f ms\n", "std::sort", std_sort );
+    measure( "std::stable_sort", []( auto& w ) { std::stable_sort( w.begin(), w.end() ); } );
+    measure( "perf::radix_sort", []( auto& w ) { perf::radix_sort( w.begin(), w.end(), by_ordinal ); } );
+    measure( "perf::stable_radix_sort", []( auto& w ) {
+        perf::stable_radix_sort( w.begin(), w.end(), by_ordinal );
+    } );
+    measure( "perf::radix_sort parallel", []( auto& w ) {
+        perf::radix_sort( perf::parallel, w.begin(), w.end(), by_ordinal );
+    } );
+    measure( "perf::stable_radix_sort parallel", []( auto& w ) {
+        perf::stable_radix_sort( perf::parallel, w.begin(), w.end(), by_ordinal );
+    } );
+}
+
+int main() {
+    std::vector<RegularWidget> widgets{ RegularWidget( 3 ), RegularWidget( -1 ), RegularWidget( 2 ) };
+    perf::radix_sort( widgets.begin(), widgets.end(), &RegularWidget::ordinal );
+    for ( const auto& w : widgets ) {
+        std::cout << w.ordinal() << " ";
+    }
+    std::cout << std::endl;
+
+    std::printf( "hardware threads %u\n", perf::hardware_threads() );
+    for ( std::size_t n = 1'000'000; n <= 100'000'000; n *= 10 ) {
+        benchmark( n );
+    }
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Summary
+//////////////////////////////////////////////////////////////////////////
+/*
+When the order comes from a single integer, a comparison sort is doing more work than it needs to.
+A radix sort moves each element once per key byte, with no comparisons to mispredict.
+
+LSD is stable but needs a second buffer, and every pass over a large array goes out to memory.
+Do one pass on the top byte first; the buckets are then small enough for LSD to finish them in cache.
+MSD works in place, at the price of swaps that hop around memory. Both skip key bytes that are the same everywhere.
+They win on large inputs; for a few hundred elements, std::sort is still the right call.
+*/
@@ -0,0 +1,80 @@
+#include <iostream>
+#include <vector>
+#include <cstdio>
+
+#include "perf/recycling_allocator.hpp"
+#include "perf/bench.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+// The same function three ways
+//////////////////////////////////////////////////////////////////////////
+// parameter_classic.cpp: the caller owns the buffer
+void heavy_result_type( std::vector<int>& out, std::size_t n = 100'000 ) {
+    out.resize( n );
+}
+
+// parameter_modern.cpp: clean interface, a fresh buffer per call
+std::vector<int> heavy_result_type( std::size_t n = 100'000 ) {
+    std::vector<int> results;
+    results.resize( n );
+    return results;
+}
+
+// same interface, the buffer comes back from the last call's destructor
+perf::recycled_vector<int> heavy_result_type_recycled( std::size_t n = 100'000 ) {
+    perf::recycled_vector<int> results;
+    results.resize( n );
+    return results;
+}
+
+void benchmark( std::size_t n, int calls ) {
+    auto report = [calls]( const char* name, double ms ) {
+        std::printf( "  %-36s %10.2f us/call\n", name, ms * 1e3 / calls );
+    };
+    std::printf( "%d calls returning %zu ints\n", calls, n );
+
+    report( "out parameter", perf::time_ms( [&] {
+        std::vector<int> results;
+        for ( int i = 0; i < calls; ++i ) {
+            // a real caller clears between uses, otherwise resize has nothing to do
+            results.clear();
+            heavy_result_type( results, n );
+            perf::do_not_optimize( results.data() );
+        }
+    } ) );
+    report( "return std::vector by value", perf::time_ms( [&] {
+        for ( int i = 0; i < calls; ++i ) {
+            auto results = heavy_result_type( n );
+            perf::do_not_optimize( results.data() );
+        }
+    } ) );
+    report( "return recycled_vector by value", perf::time_ms( [&] {
+        for ( int i = 0; i < calls; ++i ) {
+            auto results = heavy_result_type_recycled( n );
+            perf::do_not_optimize( results.data() );
+        }
+    } ) );
+}
+
+int main() {
+    // glibc already reuses blocks this size once one has been freed
+    benchmark( 100'000, 20'000 );
+    // above its 32MB mmap threshold every fresh vector is a new mapping, faulted in page by page
+    benchmark( 16'000'000, 20 );
+
+    auto stats = perf::thread_recycling_stats();
+    std::printf( "freelist hits %llu, misses %llu\n", static_cast<unsigned long long>( stats.hits ),
+                 static_cast<unsigned long long>( stats.misses ) );
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Summary
+//////////////////////////////////////////////////////////////////////////
+/*
+Out parameters exist to reuse a buffer. An allocator can reuse it for you and keep the value interface.
+
+A thread-local freelist needs no locks; bound it per size class so it can't hoard memory.
+Measure first: malloc may already recycle, it's the big mmap'd buffers that pay for page faults every time.
+The remaining cost is the zero fill from resize, see default_init_modern.cpp.
+*/
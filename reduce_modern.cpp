@@ -0,0 +1,84 @@
+#include <iostream>
+#include <array>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <random>
+#include <cstdio>
+
+#include "perf/reduce.hpp"
+#include "perf/bench.hpp"
+
+int main() {
+    //////////////////////////////////////////////////////////////////////////
+    // Compile-time use
+    //////////////////////////////////////////////////////////////////////////
+    // sum_all_the_ints from variadic_modern.cpp only works on an argument pack
+    // perf::sum works on ranges and is still usable in a constant expression
+    constexpr std::array<int, 6> sizes = { 0, 1, 2, 3, 4, 5 };
+    std::array<int, perf::sum( sizes )> values = {};
+    static_assert( perf::max_value( sizes ) == 5, "evaluated by the compiler" );
+    static_assert( perf::count( sizes, 3 ) == 1, "evaluated by the compiler" );
+    std::cout << values.size() << std::endl;
+
+    //////////////////////////////////////////////////////////////////////////
+    // Overflow
+    //////////////////////////////////////////////////////////////////////////
+    // std::accumulate(..., 0) sums in int, sum_wide sums in int64_t
+    std::vector<int> big( 1000, 1 << 30 );
+    std::cout << "sum " << perf::sum( big ) << " sum_wide " << perf::sum_wide( big ) << std::endl;
+
+    //////////////////////////////////////////////////////////////////////////
+    // Throughput
+    //////////////////////////////////////////////////////////////////////////
+    std::mt19937 rng( 42 );
+    std::uniform_int_distribution<int> dist( -1000, 1000 );
+    for ( std::size_t n : { std::size_t{ 100'000 }, std::size_t{ 10'000'000 } } ) {
+        std::vector<int> data( n );
+        std::generate( data.begin(), data.end(), [&] { return dist( rng ); } );
+        double gb = static_cast<double>( n * sizeof( int ) ) / 1e9;
+        auto report = [gb]( const char* name, double ms ) {
+            std::printf( "  %-28s %8.3f ms %7.2f GB/s\n", name, ms, gb / ( ms / 1e3 ) );
+        };
+
+        std::printf( "n = %zu\n", n );
+        report( "std::accumulate int64", perf::time_ms( [&] {
+            perf::do_not_optimize( std::accumulate( data.begin(), data.end(), std::int64_t{ 0 } ) );
+        } ) );
+        report( "perf::sum_wide", perf::time_ms( [&] { perf::do_not_optimize( perf::sum_wide( data ) ); } ) );
+        report( "perf::sum_wide parallel", perf::time_ms( [&] {
+            perf::do_not_optimize( perf::sum_wide( perf::parallel, data ) );
+        } ) );
+        report( "std::minmax_element", perf::time_ms( [&] {
+            perf::do_not_optimize( *std::minmax_element( data.begin(), data.end() ).first );
+        } ) );
+        report( "perf::minmax_value", perf::time_ms( [&] { perf::do_not_optimize( perf::minmax_value( data ).min ); } ) );
+        report( "std::count", perf::time_ms( [&] {
+            perf::do_not_optimize( std::count( data.begin(), data.end(), 7 ) );
+        } ) );
+        report( "perf::count", perf::time_ms( [&] { perf::do_not_optimize( perf::count( data, 7 ) ); } ) );
+        report( "perf::count parallel", perf::time_ms( [&] {
+            perf::do_not_optimize( perf::count( perf::parallel, data, 7 ) );
+        } ) );
+
+        if ( perf::sum_wide( data ) != std::accumulate( data.begin(), data.end(), std::int64_t{ 0 } ) ||
+             perf::count( perf::parallel, data, 7 ) != std::count( data.begin(), data.end(), 7 ) ||
+             perf::min_value( data ) != *std::min_element( data.begin(), data.end() ) ) {
+            std::cout << "MISMATCH" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Summary
+//////////////////////////////////////////////////////////////////////////
+/*
+One constexpr function can serve both worlds: a plain loop for the compiler, SIMD for the machine.
+
+Pick the accumulator type on purpose. int sums of int data overflow sooner than you think.
+
+Threads only pay off when the range is much larger than the cost of starting them, and a sum
+is memory bound long before it is compute bound.
+*/
@@ -0,0 +1,111 @@
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <cstdio>
+
+#include "perf/uninitialized.hpp"
+#include "perf/vector.hpp"
+#include "perf/bench.hpp"
+
+// same shape as the RegularWidget in class_modern.cpp
+// defaulted copy/move and no destructor, so it is trivially copyable
+class RegularWidget {
+public:
+    RegularWidget() = default;
+    explicit RegularWidget( int ordinal_ ) : ordinal( ordinal_ ) {}
+    friend bool operator==( const RegularWidget& lhs, const RegularWidget& rhs ) { return lhs.ordinal == rhs.ordinal; }
+private:
+    int ordinal = 0;
+};
+
+// owns memory, so it is not trivially copyable
+// but moving it is still just copying its bytes and forgetting the source
+struct Handle {
+    std::unique_ptr<int> value;
+    int ordinal = 0;
+};
+
+struct RelocatableHandle {
+    std::unique_ptr<int> value;
+    int ordinal = 0;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Opting in
+//////////////////////////////////////////////////////////////////////////
+// a promise that memcpy + forgetting the source is a valid move
+template<> struct perf::is_trivially_relocatable<RelocatableHandle> : std::true_type {};
+
+static_assert( perf::is_trivially_relocatable_v<RegularWidget>, "detected automatically" );
+static_assert( !perf::is_trivially_relocatable_v<Handle>, "not without opting in" );
+static_assert( perf::is_trivially_relocatable_v<RelocatableHandle>, "opted in" );
+
+template< typename Vector >
+void grow( int n ) {
+    Vector v;
+    for ( int i = 0; i < n; ++i ) {
+        v.push_back( { nullptr, i } );
+    }
+    perf::do_not_optimize( v.data() );
+}
+
+template< typename Vector >
+void insert_front( int n ) {
+    Vector v;
+    for ( int i = 0; i < n; ++i ) {
+        v.insert( v.begin(), { nullptr, i } );
+    }
+    perf::do_not_optimize( v.data() );
+}
+
+int main() {
+    //////////////////////////////////////////////////////////////////////////
+    // Bulk construction
+    //////////////////////////////////////////////////////////////////////////
+    // construct_n is the bulk version of construct(T*, Args&&...) from variadic_modern.cpp
+    // for trivial types it is a memset or a memcpy, not a loop of placement news
+    alignas( RegularWidget ) unsigned char storage[sizeof( RegularWidget ) * 16];
+    auto widgets = reinterpret_cast<RegularWidget*>( storage );
+    perf::construct_n( widgets, 16, RegularWidget{ 7 } );
+    std::cout << ( widgets[15] == RegularWidget{ 7 } ) << std::endl;
+    perf::destroy_n( widgets, 16 );
+
+    //////////////////////////////////////////////////////////////////////////
+    // Growth and shifting
+    //////////////////////////////////////////////////////////////////////////
+    // the fill value may be one of the elements, it is copied before the old buffer is freed
+    perf::vector<RegularWidget> row;
+    row.push_back( RegularWidget{ 3 } );
+    row.resize( 100, row[0] );
+    std::cout << ( row[99] == RegularWidget{ 3 } ) << std::endl;
+
+    const int grow_count = 1'000'000;
+    const int insert_count = 20'000;
+    std::printf( "push_back %d elements (no reserve)\n", grow_count );
+    std::printf( "  %-36s %8.3f ms\n", "std::vector<Handle>", perf::time_ms( [&] { grow<std::vector<Handle>>( grow_count ); } ) );
+    std::printf( "  %-36s %8.3f ms\n", "perf::vector<Handle>", perf::time_ms( [&] { grow<perf::vector<Handle>>( grow_count ); } ) );
+    std::printf( "  %-36s %8.3f ms\n", "perf::vector<RelocatableHandle>",
+                 perf::time_ms( [&] { grow<perf::vector<RelocatableHandle>>( grow_count ); } ) );
+
+    std::printf( "insert %d elements at the front\n", insert_count );
+    std::printf( "  %-36s %8.3f ms\n", "std::vector<Handle>",
+                 perf::time_ms( [&] { insert_front<std::vector<Handle>>( insert_count ); }, 1 ) );
+    std::printf( "  %-36s %8.3f ms\n", "perf::vector<Handle>",
+                 perf::time_ms( [&] { insert_front<perf::vector<Handle>>( insert_count ); }, 1 ) );
+    std::printf( "  %-36s %8.3f ms\n", "perf::vector<RelocatableHandle>",
+                 perf::time_ms( [&] { insert_front<perf::vector<RelocatableHandle>>( insert_count ); }, 1 ) );
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Summary
+//////////////////////////////////////////////////////////////////////////
+/*
+Most types can be moved by copying their bytes: anything that only owns heap memory through
+unique_ptr, vector, etc. The standard library can't know that, so it moves and destroys one
+element at a time.
+
+Opt types in explicitly and only when you are sure. A type that points into itself breaks.
+
+Trivially copyable types are detected for free.
+*/
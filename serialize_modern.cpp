@@ -0,0 +1,171 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+
+#include "perf/serialize.hpp"
+#include "perf/bench.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+// Types from the other examples
+//////////////////////////////////////////////////////////////////////////
+// Foo from typedef_modern.cpp
+using Foo = struct {
+    int vlaue;
+};
+
+// Shape from functor_modern.cpp
+enum ShapeType {
+    SHAPE_CIRCLE,
+    SHAPE_SQUARE,
+    SHAPE_TRIANGLE,
+    SHAPE_RHOMBUS
+};
+
+struct Shape {
+    Shape( ShapeType type_ = SHAPE_CIRCLE ) : type( type_ ) {}
+    ShapeType type;
+};
+
+// RegularWidget from class_modern.cpp, its field list needs access to the private member
+class RegularWidget {
+public:
+    RegularWidget() = default;
+    explicit RegularWidget( int ordinal_ ) : ordinal( ordinal_ ) {}
+    friend bool operator==( const RegularWidget& lhs, const RegularWidget& rhs ) { return lhs.ordinal == rhs.ordinal; }
+private:
+    friend struct perf::field_list<RegularWidget>;
+    int ordinal = 0;
+};
+
+// no padding, so the encoded form is the object representation
+struct Order {
+    std::int64_t id;
+    double price;
+    std::int32_t qty;
+    std::int32_t side;
+};
+
+// padding after id and qty, encoded field by field
+struct Tick {
+    std::int32_t id;
+    double price;
+    std::int16_t qty;
+};
+
+// variable size members
+struct Player {
+    int id = 0;
+    std::string name;
+    std::vector<Order> orders;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Field lists
+//////////////////////////////////////////////////////////////////////////
+// the only thing written by hand, one line per type, checked by the compiler
+template<> struct perf::field_list<Foo> : perf::fields<&Foo::vlaue> {};
+template<> struct perf::field_list<Shape> : perf::fields<&Shape::type> {};
+template<> struct perf::field_list<RegularWidget> : perf::fields<&RegularWidget::ordinal> {};
+template<> struct perf::field_list<Order> : perf::fields<&Order::id, &Order::price, &Order::qty, &Order::side> {};
+template<> struct perf::field_list<Tick> : perf::fields<&Tick::id, &Tick::price, &Tick::qty> {};
+template<> struct perf::field_list<Player> : perf::fields<&Player::id, &Player::name, &Player::orders> {};
+
+static_assert( perf::is_bulk_serializable_v<Order>, "one memcpy" );
+static_assert( !perf::is_bulk_serializable_v<Tick> && perf::fixed_size_v<Tick> == 14, "packed, field by field" );
+static_assert( !perf::is_fixed_size_v<Player>, "size depends on the value" );
+
+//////////////////////////////////////////////////////////////////////////
+// Naive serializer
+//////////////////////////////////////////////////////////////////////////
+// what the hand-written version usually looks like
+void write_naive( std::ostream& os, const Tick& t ) {
+    os.write( reinterpret_cast<const char*>( &t.id ), sizeof( t.id ) );
+    os.write( reinterpret_cast<const char*>( &t.price ), sizeof( t.price ) );
+    os.write( reinterpret_cast<const char*>( &t.qty ), sizeof( t.qty ) );
+}
+
+void write_naive( std::ostream& os, const Order& o ) {
+    os.write( reinterpret_cast<const char*>( &o.id ), sizeof( o.id ) );
+    os.write( reinterpret_cast<const char*>( &o.price ), sizeof( o.price ) );
+    os.write( reinterpret_cast<const char*>( &o.qty ), sizeof( o.qty ) );
+    os.write( reinterpret_cast<const char*>( &o.side ), sizeof( o.side ) );
+}
+
+template< typename T >
+void benchmark( const char* name, const std::vector<T>& records ) {
+    const std::size_t bytes = records.size() * perf::fixed_size_v<T>;
+    const double gb = static_cast<double>( bytes ) / 1e9;
+    std::vector<std::byte> buffer( bytes );
+    std::vector<T> decoded( records.size() );
+
+    double naive = perf::time_ms( [&] {
+        std::ostringstream os;
+        for ( const auto& r : records ) {
+            write_naive( os, r );
+        }
+        perf::do_not_optimize( os.tellp() );
+    } );
+    double encode = perf::time_ms( [&] {
+        std::byte* out = buffer.data();
+        for ( const auto& r : records ) {
+            out = perf::encode( r, out );
+        }
+        perf::do_not_optimize( out );
+    } );
+    double encode_n = perf::time_ms( [&] { perf::do_not_optimize( perf::encode_n( records.data(), records.size(), buffer.data() ) ); } );
+    double decode_n = perf::time_ms( [&] { perf::do_not_optimize( perf::decode_n( buffer.data(), records.size(), decoded.data() ) ); } );
+
+    std::printf( "%s, %zu records, %zu bytes\n", name, records.size(), bytes );
+    std::printf( "  %-24s %8.2f GB/s\n", "naive ostream", gb / ( naive / 1e3 ) );
+    std::printf( "  %-24s %8.2f GB/s\n", "perf::encode per record", gb / ( encode / 1e3 ) );
+    std::printf( "  %-24s %8.2f GB/s\n", "perf::encode_n", gb / ( encode_n / 1e3 ) );
+    std::printf( "  %-24s %8.2f GB/s\n", "perf::decode_n", gb / ( decode_n / 1e3 ) );
+}
+
+int main() {
+    //////////////////////////////////////////////////////////////////////////
+    // Round trip
+    //////////////////////////////////////////////////////////////////////////
+    Player player{ 76, "tracer", { { 1, 9.5, 100, 0 }, { 2, 9.75, 50, 1 } } };
+    std::vector<std::byte> buffer( perf::encoded_size( player ) );
+    perf::encode( player, buffer.data() );
+
+    Player copy;
+    perf::decode( buffer.data(), copy );
+    std::cout << copy.name << " " << copy.orders.size() << " orders, " << buffer.size() << " bytes" << std::endl;
+
+    RegularWidget widget{ 7 }, widget2;
+    std::byte small[sizeof( RegularWidget )];
+    perf::encode( widget, small );
+    perf::decode( small, widget2 );
+    std::cout << ( widget == widget2 ) << std::endl;
+
+    //////////////////////////////////////////////////////////////////////////
+    // Throughput
+    //////////////////////////////////////////////////////////////////////////
+    const std::size_t count = 1'000'000;
+    std::vector<Order> orders( count );
+    std::vector<Tick> ticks( count );
+    for ( std::size_t i = 0; i < count; ++i ) {
+        orders[i] = { static_cast<std::int64_t>( i ), i * 0.5, static_cast<std::int32_t>( i ), 1 };
+        ticks[i] = { static_cast<std::int32_t>( i ), i * 0.5, static_cast<std::int16_t>( i ) };
+    }
+    benchmark( "Order (bulk)", orders );
+    benchmark( "Tick (field by field)", ticks );
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Summary
+//////////////////////////////////////////////////////////////////////////
+/*
+Describe a type once, generate the code from the description. The description can't drift
+the way a hand-written serializer does: rename or retype a member and it stops compiling.
+
+Every size and offset is known at compile time, so the generated code is straight-line copies.
+
+Lay out hot wire types without padding and the whole thing collapses into one memcpy.
+*/
@@ -0,0 +1,144 @@
+#include <iostream>
+#include <vector>
+#include <numeric>
+#include <mutex>
+#include <thread>
+#include <memory>
+#include <random>
+#include <chrono>
+#include <cstdio>
+
+#include "perf/small_lock.hpp"
+#include "perf/bench.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+// Three ways to guard the cache
+//////////////////////////////////////////////////////////////////////////
+// the qualifiers_modern.cpp recipe
+class MutexWidget {
+public:
+    int sum() const {
+        std::lock_guard<std::mutex> _{ m_cached_mutex };
+        if ( m_cached == -1 ) {
+            m_cached = std::accumulate( begin( m_data ), end( m_data ), 0 );
+        }
+        return m_cached;
+    }
+    void set( std::size_t i, int v ) {
+        std::lock_guard<std::mutex> _{ m_cached_mutex };
+        m_data[i] = v;
+        m_cached = -1;
+    }
+    std::vector<int>& data() { return m_data; }
+
+private:
+    std::vector<int> m_data;
+    mutable std::mutex m_cached_mutex;
+    mutable int m_cached = -1;
+};
+
+// the lock fits in the padding after m_cached
+class ByteLockWidget {
+public:
+    int sum() const {
+        std::lock_guard<perf::byte_lock> _{ m_cached_lock };
+        if ( m_cached == -1 ) {
+            m_cached = std::accumulate( begin( m_data ), end( m_data ), 0 );
+        }
+        return m_cached;
+    }
+    void set( std::size_t i, int v ) {
+        std::lock_guard<perf::byte_lock> _{ m_cached_lock };
+        m_data[i] = v;
+        m_cached = -1;
+    }
+    std::vector<int>& data() { return m_data; }
+
+private:
+    std::vector<int> m_data;
+    mutable int m_cached = -1;
+    mutable perf::byte_lock m_cached_lock;
+};
+
+// no lock in the object at all
+class StripedWidget {
+public:
+    int sum() const {
+        std::lock_guard<std::mutex> _{ perf::shared_lock_table().for_address( this ) };
+        if ( m_cached == -1 ) {
+            m_cached = std::accumulate( begin( m_data ), end( m_data ), 0 );
+        }
+        return m_cached;
+    }
+    void set( std::size_t i, int v ) {
+        std::lock_guard<std::mutex> _{ perf::shared_lock_table().for_address( this ) };
+        m_data[i] = v;
+        m_cached = -1;
+    }
+    std::vector<int>& data() { return m_data; }
+
+private:
+    std::vector<int> m_data;
+    mutable int m_cached = -1;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Many widgets, many threads
+//////////////////////////////////////////////////////////////////////////
+// million operations per second, one in 16 is a write
+template< typename Widget >
+double throughput( std::size_t widget_count, unsigned threads, int ops_per_thread ) {
+    std::unique_ptr<Widget[]> widgets( new Widget[widget_count] );
+    for ( std::size_t i = 0; i < widget_count; ++i ) {
+        widgets[i].data().assign( 8, static_cast<int>( i ) );
+    }
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for ( unsigned t = 0; t < threads; ++t ) {
+        workers.emplace_back( [&, t] {
+            std::minstd_rand rng( t + 1 );
+            for ( int i = 0; i < ops_per_thread; ++i ) {
+                auto& w = widgets[rng() % widget_count];
+                if ( i % 16 == 0 ) {
+                    w.set( 0, i );
+                } else {
+                    perf::do_not_optimize( w.sum() );
+                }
+            }
+        } );
+    }
+    for ( auto& w : workers ) {
+        w.join();
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return double( threads ) * ops_per_thread / elapsed.count();
+}
+
+int main() {
+    std::printf( "bytes per widget (std::vector<int> is %zu of them)\n", sizeof( std::vector<int> ) );
+    std::printf( "  %-16s %3zu (std::mutex alone is %zu)\n", "std::mutex", sizeof( MutexWidget ), sizeof( std::mutex ) );
+    std::printf( "  %-16s %3zu\n", "perf::byte_lock", sizeof( ByteLockWidget ) );
+    std::printf( "  %-16s %3zu (+ %zu shared stripes of 64 bytes)\n", "striped table", sizeof( StripedWidget ),
+                 perf::shared_lock_table().stripes() );
+
+    const std::size_t widgets = 1'000'000;
+    const int ops = 2'000'000;
+    std::printf( "%zu widgets, %d random sum()/set() per thread, Mops/s\n", widgets, ops );
+    std::printf( "  %7s %12s %12s %12s\n", "threads", "std::mutex", "byte_lock", "striped" );
+    for ( unsigned threads = 1; threads <= 8; threads *= 2 ) {
+        std::printf( "  %7u %12.2f %12.2f %12.2f\n", threads, throughput<MutexWidget>( widgets, threads, ops ),
+                     throughput<ByteLockWidget>( widgets, threads, ops ), throughput<StripedWidget>( widgets, threads, ops ) );
+    }
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Summary
+//////////////////////////////////////////////////////////////////////////
+/*
+A lock per object is a lot of bytes for a rarely contended critical section.
+Fewer bytes per object means more objects per cache line, which matters more than the lock.
+
+A one byte spin lock is enough when critical sections are tiny.
+A striped table moves the lock out of the object entirely; just never hold two stripes at once.
+*/
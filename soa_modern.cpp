@@ -0,0 +1,215 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdint>
+#include <cstdio>
+
+#include "perf/soa.hpp"
+#include "perf/reduce.hpp"
+#include "perf/bench.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+// Types from the other examples
+//////////////////////////////////////////////////////////////////////////
+// Shape from functor_modern.cpp, with somewhere to draw it
+enum ShapeType {
+    SHAPE_CIRCLE,
+    SHAPE_SQUARE,
+    SHAPE_TRIANGLE,
+    SHAPE_RHOMBUS
+};
+
+struct Shape {
+    Shape( ShapeType type_ = SHAPE_CIRCLE ) : type( type_ ) {}
+    ShapeType type;
+    float x = 0, y = 0;
+    float size = 1;
+    std::uint32_t color = 0;
+};
+
+// Order from serialize_modern.cpp
+struct Order {
+    std::int64_t id;
+    double price;
+    std::int32_t qty;
+    std::int32_t side;
+};
+
+// RegularWidget from class_modern.cpp, its field list needs access to the private member
+class RegularWidget {
+public:
+    RegularWidget() = default;
+    explicit RegularWidget( int ordinal_ ) : ordinal( ordinal_ ) {}
+    int Ordinal() const { return ordinal; }
+private:
+    friend struct perf::field_list<RegularWidget>;
+    int ordinal = 0;
+};
+
+template<> struct perf::field_list<Shape>
+    : perf::fields<&Shape::type, &Shape::x, &Shape::y, &Shape::size, &Shape::color> {};
+template<> struct perf::field_list<Order> : perf::fields<&Order::id, &Order::price, &Order::qty, &Order::side> {};
+template<> struct perf::field_list<RegularWidget> : perf::fields<&RegularWidget::ordinal> {};
+
+//////////////////////////////////////////////////////////////////////////
+// Benchmarks
+//////////////////////////////////////////////////////////////////////////
+constexpr std::size_t count = 4'000'000;
+
+void report( const char* name, double aos_ms, double soa_ms ) {
+    std::printf( "  %-38s std::vector %8.2f ms  perf::soa_vector %8.2f ms %6.2fx\n", name, aos_ms, soa_ms,
+                 aos_ms / soa_ms );
+}
+
+void benchmark_shapes() {
+    std::mt19937 rng( 42 );
+    std::vector<Shape> aos;
+    perf::soa_vector<Shape> soa;
+    for ( std::size_t i = 0; i < count; ++i ) {
+        Shape shape( static_cast<ShapeType>( rng() % 4 ) );
+        shape.x = static_cast<float>( rng() % 1000 );
+        shape.y = static_cast<float>( rng() % 1000 );
+        shape.color = rng();
+        aos.push_back( shape );
+        soa.push_back( shape );
+    }
+    std::printf( "%zu shapes, %zu bytes each\n", count, sizeof( Shape ) );
+
+    // one field of five
+    double aos_ms = perf::time_ms( [&] {
+        auto circles = std::count_if( aos.begin(), aos.end(), []( const Shape& s ) { return s.type == SHAPE_CIRCLE; } );
+        perf::do_not_optimize( circles );
+    } );
+    double soa_ms = perf::time_ms( [&] {
+        auto types = soa.column<&Shape::type>();
+        auto circles = std::count( types.begin(), types.end(), SHAPE_CIRCLE );
+        perf::do_not_optimize( circles );
+    } );
+    report( "count circles", aos_ms, soa_ms );
+
+    // two fields of five, written back
+    aos_ms = perf::time_ms( [&] {
+        for ( Shape& s : aos ) {
+            s.x += 1.0f;
+            s.y -= 1.0f;
+        }
+        perf::do_not_optimize( aos.data() );
+    } );
+    soa_ms = perf::time_ms( [&] {
+        auto xs = soa.column<&Shape::x>();
+        auto ys = soa.column<&Shape::y>();
+        for ( std::size_t i = 0; i < xs.size(); ++i ) {
+            xs[i] += 1.0f;
+            ys[i] -= 1.0f;
+        }
+        perf::do_not_optimize( xs.data() );
+    } );
+    report( "move every shape", aos_ms, soa_ms );
+
+    // whole records in random order: one cache miss per record for AoS, one per field for SoA
+    std::vector<std::uint32_t> picks( count / 4 );
+    for ( auto& i : picks ) {
+        i = static_cast<std::uint32_t>( rng() % count );
+    }
+    aos_ms = perf::time_ms( [&] {
+        float total = 0;
+        for ( std::uint32_t i : picks ) {
+            const Shape& s = aos[i];
+            total += s.x + s.y + s.size + static_cast<float>( s.type + ( s.color & 1 ) );
+        }
+        perf::do_not_optimize( total );
+    } );
+    soa_ms = perf::time_ms( [&] {
+        float total = 0;
+        for ( std::uint32_t i : picks ) {
+            Shape s = soa[i];
+            total += s.x + s.y + s.size + static_cast<float>( s.type + ( s.color & 1 ) );
+        }
+        perf::do_not_optimize( total );
+    } );
+    report( "whole records, random order", aos_ms, soa_ms );
+}
+
+void benchmark_orders() {
+    std::mt19937 rng( 42 );
+    std::vector<Order> aos( count );
+    for ( std::size_t i = 0; i < count; ++i ) {
+        aos[i] = Order{ static_cast<std::int64_t>( i ), 100.0 + rng() % 1000 / 100.0, static_cast<std::int32_t>( rng() % 500 ),
+                        static_cast<std::int32_t>( rng() % 2 ) };
+    }
+    perf::soa_vector<Order> soa;
+    soa.reserve( count );
+    for ( const Order& order : aos ) {
+        soa.push_back( order );
+    }
+    std::printf( "%zu orders, %zu bytes each\n", count, sizeof( Order ) );
+
+    double aos_ms = perf::time_ms( [&] {
+        long long volume = 0;
+        for ( const Order& order : aos ) {
+            volume += order.qty;
+        }
+        perf::do_not_optimize( volume );
+    } );
+    double soa_ms = perf::time_ms( [&] {
+        auto qty = soa.column<&Order::qty>();
+        long long volume = perf::sum_wide( qty.begin(), qty.end() );
+        perf::do_not_optimize( volume );
+    } );
+    report( "total quantity", aos_ms, soa_ms );
+
+    aos_ms = perf::time_ms( [&] {
+        double notional = 0;
+        for ( const Order& order : aos ) {
+            notional += order.price * order.qty;
+        }
+        perf::do_not_optimize( notional );
+    } );
+    soa_ms = perf::time_ms( [&] {
+        auto price = soa.column<&Order::price>();
+        auto qty = soa.column<&Order::qty>();
+        double notional = 0;
+        for ( std::size_t i = 0; i < price.size(); ++i ) {
+            notional += price[i] * qty[i];
+        }
+        perf::do_not_optimize( notional );
+    } );
+    report( "total notional", aos_ms, soa_ms );
+}
+
+int main() {
+    // reads like a vector of records
+    perf::soa_vector<Shape> shapes = { Shape( SHAPE_CIRCLE ), Shape( SHAPE_SQUARE ), Shape( SHAPE_CIRCLE ) };
+    shapes.push_back( SHAPE_RHOMBUS );
+    shapes[1].get<&Shape::x>() = 2.0f;
+    Shape second = shapes[1];
+    std::cout << second.type << " " << second.x << std::endl;
+
+    // but each field is its own array
+    auto types = shapes.column<&Shape::type>();
+    std::cout << std::count( types.begin(), types.end(), SHAPE_CIRCLE ) << " "
+              << reinterpret_cast<std::uintptr_t>( types.data() ) % decltype( types )::alignment << std::endl;
+
+    // private members work through the friend field list
+    perf::soa_vector<RegularWidget> widgets;
+    widgets.emplace_back( 7 );
+    std::cout << static_cast<RegularWidget>( widgets[0] ).Ordinal() << std::endl;
+
+    benchmark_shapes();
+    benchmark_orders();
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Summary
+//////////////////////////////////////////////////////////////////////////
+/*
+A std::vector of records stores every field of a record together.
+A loop that reads one field still drags the whole record through the cache, so most of every cache line it loads is wasted.
+A structure of arrays stores each field in its own array.
+A scan over one field then reads only that field, densely, and the loop is a plain array loop the compiler or a SIMD kernel can vectorize.
+The gain grows with the share of each record the loop skips: one 4 byte field of a 24 byte record reads a sixth of the memory.
+The cost shows up when you need whole records. Each one is gathered from one place per field, and appending writes to every column.
+Pick the layout from the hot loops. Use SoA when they touch a few fields of many records, and keep AoS when they work record by record.
+*/
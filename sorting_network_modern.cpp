@@ -0,0 +1,104 @@
+#include <iostream>
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdio>
+
+#include "perf/sorting_network.hpp"
+#include "perf/bench.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+// RegularWidget from class_modern.cpp
+//////////////////////////////////////////////////////////////////////////
+class RegularWidget {
+public:
+    RegularWidget() = default;
+    explicit RegularWidget( int ordinal ) : m_ordinal( ordinal ) {}
+
+    int ordinal() const { return m_ordinal; }
+
+    friend bool operator==( const RegularWidget& lhs, const RegularWidget& rhs ) { return lhs.m_ordinal == rhs.m_ordinal; }
+    friend bool operator<( const RegularWidget& lhs, const RegularWidget& rhs ) { return lhs.m_ordinal < rhs.m_ordinal; }
+
+private:
+    int m_ordinal = 0;
+};
+
+// sorts a million arrays of N elements each way, every sort starts from the same shuffled copy
+template< typename T, std::size_t N, typename Make >
+void benchmark( const char* type, Make make ) {
+    constexpr std::size_t count = 1'000'000;
+    std::mt19937 rng( 42 );
+    std::vector<std::array<T, N>> shuffled( count );
+    for ( auto& a : shuffled ) {
+        for ( auto& x : a ) {
+            x = make( rng );
+        }
+    }
+
+    std::vector<std::array<T, N>> expected = shuffled;
+    double std_sort = perf::time_ms( [&] {
+        for ( auto& a : expected ) {
+            std::sort( a.begin(), a.end() );
+        }
+    }, 1 );
+
+    auto measure = [&]( const char* name, auto sort ) {
+        std::vector<std::array<T, N>> arrays = shuffled;
+        double ms = perf::time_ms( [&] {
+            for ( auto& a : arrays ) {
+                sort( a );
+            }
+        }, 1 );
+        std::printf( "  %-24s %8.1f ns/array %8.2fx %s\n", name, ms * 1e6 / count, std_sort / ms,
+                     arrays == expected ? "" : "WRONG" );
+    };
+    std::printf( "std::array<%s, %zu>\n", type, N );
+    std::printf( "  %-24s %8.1f ns/array\n", "std::sort", std_sort * 1e6 / count );
+    measure( "perf::sort_network", []( auto& a ) { perf::sort_network( a ); } );
+    if constexpr ( std::is_same<T, int>::value ) {
+        measure( "perf::sort_network_simd", []( auto& a ) { perf::sort_network_simd( a ); } );
+    }
+}
+
+template< std::size_t N >
+void benchmark_size() {
+    benchmark<int, N>( "int", []( std::mt19937& rng ) { return static_cast<int>( rng() ); } );
+    benchmark<RegularWidget, N>( "RegularWidget", []( std::mt19937& rng ) { return RegularWidget( static_cast<int>( rng() ) ); } );
+}
+
+int main() {
+    // the std::array<int, 6> of arrays_modern.cpp
+    std::array<int, 6> values = { 5, 3, 6, 4, 1, 2 };
+    perf::sort_network( values );
+    for ( int v : values ) {
+        std::cout << v << " ";
+    }
+    std::cout << std::endl;
+
+    benchmark_size<4>();
+    benchmark_size<6>();
+    benchmark_size<8>();
+    benchmark_size<12>();
+    benchmark_size<16>();
+    benchmark_size<20>();
+    benchmark_size<24>();
+    benchmark_size<28>();
+    benchmark_size<32>();
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Summary
+//////////////////////////////////////////////////////////////////////////
+/*
+When you sort a tiny array, std::sort is mostly overhead: size checks, loops, and branches that mispredict on random data.
+A sorting network makes the same compare-exchanges for every input, so each one can be a branchless min / max.
+Generate the network at compile time from N and unroll it, and the elements stay in registers.
+
+For ints, a bitonic network can run across the lanes of AVX2 registers, eight compare-exchanges per instruction.
+Optimizers often vectorize the plain network over ints on their own, so measure before you reach for the intrinsics.
+A ?: between structs often compiles to branches, which cost more than the sort once N reaches a dozen or so. Blending the bytes with a mask stays branch-free at every size.
+Networks grow as N log^2 N. Use them for arrays of a few dozen elements at most, and only when the size is known at compile time.
+*/
@@ -0,0 +1,91 @@
+#include <iostream>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <random>
+#include <cstdio>
+#include <cstdint>
+
+#include "perf/tracked_vector.hpp"
+#include "perf/bench.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+// Widget from qualifiers_modern.cpp, without the stale cache
+//////////////////////////////////////////////////////////////////////////
+class Widget {
+public:
+    using data_type = perf::tracked_vector<int, perf::sum_aggregate<int>, perf::minmax_tree<int>>;
+
+    const data_type& data() const & { return m_data; }
+    // still mutable access, but every write goes through the tracked interface
+    data_type& data() & { return m_data; }
+
+    // never rescans, whatever the caller did through data()
+    std::int64_t sum() const { return m_data.aggregate<perf::sum_aggregate<int>>().value(); }
+    int min() const { return m_data.aggregate<perf::minmax_tree<int>>().min(); }
+    int max() const { return m_data.aggregate<perf::minmax_tree<int>>().max(); }
+
+private:
+    data_type m_data;
+};
+
+int main() {
+    Widget w;
+    auto& d = w.data();
+    for ( int i = 0; i < 10; ++i ) {
+        d.push_back( i );
+    }
+    d[3] = 100;
+    d[4] += 10;
+    d.pop_back();
+    std::cout << w.sum() << " " << w.min() << " " << w.max() << std::endl;
+
+    //////////////////////////////////////////////////////////////////////////
+    // Point updates followed by a query
+    //////////////////////////////////////////////////////////////////////////
+    const int updates = 1'000;
+    std::mt19937 rng( 5 );
+    std::printf( "%d random element updates, each followed by sum + min/max\n", updates );
+    std::printf( "  %10s %16s %16s %10s\n", "elements", "rescan", "tracked", "speedup" );
+    for ( std::size_t n : { std::size_t{ 1'000 }, std::size_t{ 100'000 }, std::size_t{ 1'000'000 } } ) {
+        std::vector<int> plain( n );
+        std::generate( plain.begin(), plain.end(), [&] { return static_cast<int>( rng() % 1'000'000 ); } );
+        Widget::data_type tracked( plain );
+        std::vector<std::pair<std::size_t, int>> writes( updates );
+        for ( auto& wr : writes ) {
+            wr = { rng() % n, static_cast<int>( rng() % 1'000'000 ) };
+        }
+
+        std::int64_t check_plain = 0;
+        double rescan = perf::time_ms( [&] {
+            for ( auto& wr : writes ) {
+                plain[wr.first] = wr.second;
+                auto mm = std::minmax_element( plain.begin(), plain.end() );
+                check_plain += std::accumulate( plain.begin(), plain.end(), std::int64_t{ 0 } ) + *mm.first + *mm.second;
+            }
+        }, 1 );
+        std::int64_t check_tracked = 0;
+        double incremental = perf::time_ms( [&] {
+            for ( auto& wr : writes ) {
+                tracked.set( wr.first, wr.second );
+                auto& mm = tracked.aggregate<perf::minmax_tree<int>>();
+                check_tracked += tracked.aggregate<perf::sum_aggregate<int>>().value() + mm.min() + mm.max();
+            }
+        }, 1 );
+        std::printf( "  %10zu %10.3f us/op %10.3f us/op %9.0fx%s\n", n, rescan * 1e3 / updates, incremental * 1e3 / updates, rescan / incremental,
+                     check_plain == check_tracked ? "" : "  MISMATCH" );
+    }
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Summary
+//////////////////////////////////////////////////////////////////////////
+/*
+A cache is only as good as its invalidation. Handing out a mutable reference to the data means you have none.
+
+Instead of invalidating and recomputing, route writes through the owner and update the aggregate:
+a sum takes the difference in O(1), min/max take a segment tree and O(log n).
+
+Reads stay free; the cost moves to writes, where it's proportional to what changed.
+*/